@@ -2,6 +2,7 @@
 #define GRAPH_H__
 
 #include <stdio.h>
+#include <stdint.h>
 
 // Macro
 
@@ -50,6 +51,61 @@
 */
 #define _GRAPH_OS_ERROR__ -6
 
+/**
+ * \brief Distance to an unreachable vertex
+*/
+#define _GRAPH_INFINITY__ SIZE_MAX
+
+/**
+ * \brief Graph with directed edges
+*/
+#define _GRAPH_DIRECTED__ 0
+
+/**
+ * \brief Graph with undirected edges stored once
+*/
+#define _GRAPH_UNDIRECTED__ 1
+
+/**
+ * \brief Reverse Cuthill-McKee order of vertices (small bandwidth of adjacency)
+*/
+#define _GRAPH_REORDER_RCM__ 0
+
+/**
+ * \brief Order of vertices by decreasing degree (hubs packed together)
+*/
+#define _GRAPH_REORDER_DEGREE__ 1
+
+/**
+ * \brief Breadth-first order of vertices
+*/
+#define _GRAPH_REORDER_BFS__ 2
+
+/**
+ * \brief Minimum spanning forest algorithm chosen by the density of graph
+*/
+#define _GRAPH_MST_AUTO__ 0
+
+/**
+ * \brief Kruskal's algorithm with parallel radix sort of edges
+*/
+#define _GRAPH_MST_KRUSKAL__ 1
+
+/**
+ * \brief Prim's algorithm with indexed heap
+*/
+#define _GRAPH_MST_PRIM__ 2
+
+/**
+ * \brief Parallel Boruvka's algorithm
+*/
+#define _GRAPH_MST_BORUVKA__ 3
+
+/**
+ * \brief Max amount of sources searched together by multi-source breadth-first search
+*/
+#define _GRAPH_MS_BFS_SOURCES__ 256
+
 // Structs and functions
 
 /**
@@ -66,6 +122,24 @@ struct matrix
     size_t columns;
 };
 
+/**
+ * \brief Sparse matrix in compressed sparse rows format
+ * 
+ * \param row_offsets Dynamic array of `rows + 1` positions of rows in columns and values arrays
+ * \param column_indexes Dynamic array of columns of nonzero values
+ * \param values Dynamic array of nonzero values
+ * \param rows Amount of rows in matrix
+ * \param columns Amount of columns in matrix
+ */
+struct sparse_matrix
+{
+    size_t *row_offsets;
+    size_t *column_indexes;
+    double *values;
+    size_t rows;
+    size_t columns;
+};
+
 /**
  * \brief Edge of graph
  * 
@@ -80,6 +154,11 @@ struct edge
     size_t length;                    
 };
 
+/**
+ * \brief Log of modifications deferred until the batch is committed
+ */
+struct graph_batch;
+
 /**
  * \brief Graph
  * 
@@ -87,6 +166,9 @@ struct edge
  * \param vertices_amount Length of vertices array
  * \param edges Dynamic array of edges
  * \param edges_amount Length of edges array
+ * \param mode `_GRAPH_DIRECTED__` / `_GRAPH_UNDIRECTED__`
+ * \param generation Number changed by every modification of graph
+ * \param batch Log of modifications of an open batch (`NULL` outside of a batch)
  */
 struct graph
 {
@@ -94,8 +176,115 @@ struct graph
     size_t vertices_amount; 
     struct edge *edges;     
     size_t edges_amount;    
+    int mode;
+    size_t generation;
+    struct graph_batch *batch;
 };
 
+/**
+ * \brief Path in graph
+ * 
+ * \param vertices Dynamic array of vertices indexes (in the order of `graph->vertices`)
+ * \param vertices_amount Length of vertices array
+ * \param length Length of path (sum of edges lengths)
+ */
+struct graph_path
+{
+    size_t *vertices;
+    size_t vertices_amount;
+    size_t length;
+};
+
+/**
+ * \brief Neighbourhood of vertex in graph
+ * 
+ * \param vertices Dynamic array of vertices indexes (in the order of `graph->vertices`)
+ * \param hops Dynamic array of hops from the source to the vertices
+ * \param vertices_amount Length of vertices and hops arrays
+ */
+struct graph_neighbourhood
+{
+    size_t *vertices;
+    size_t *hops;
+    size_t vertices_amount;
+};
+
+/**
+ * \brief Spanning forest of graph
+ * 
+ * \param edges Dynamic array of edges indexes (in the order of `graph->edges`)
+ * \param edges_amount Length of edges array
+ * \param length Total length of edges
+ */
+struct graph_spanning_forest
+{
+    size_t *edges;
+    size_t edges_amount;
+    size_t length;
+};
+
+/**
+ * \brief Read-only compressed adjacency of graph
+ * 
+ * \param vertices_amount Amount of vertices
+ * \param edges_amount Amount of edges
+ * \param offsets Dynamic array of positions of vertices neighbour lists in data
+ * \param data Neighbour lists: varint degree, then varint gap to the previous neighbour and varint length of every edge
+ * \param data_size Used size of data
+ * \param data_capacity Allocated size of data
+ * \param skip_starts Dynamic array of positions of vertices samples in skips
+ * \param skips Dynamic array of samples: neighbour and position after it for every 64th neighbour of a vertex
+ * \param skips_amount Amount of samples
+ * \param skips_capacity Allocated amount of samples
+ * \param appended Amount of vertices whose neighbour lists are filled
+ */
+struct graph_compressed
+{
+    size_t vertices_amount;
+    size_t edges_amount;
+    size_t *offsets;
+    unsigned char *data;
+    size_t data_size;
+    size_t data_capacity;
+    size_t *skip_starts;
+    size_t (*skips)[2];
+    size_t skips_amount;
+    size_t skips_capacity;
+    size_t appended;
+};
+
+/**
+ * \brief Iterator over neighbours of a vertex in compressed adjacency
+ * 
+ * \param position Position of the next encoded neighbour
+ * \param remaining Amount of neighbours left
+ * \param neighbour Last decoded neighbour
+ * \param started Whether a neighbour was decoded
+ */
+struct graph_compressed_iterator
+{
+    const unsigned char *position;
+    size_t remaining;
+    size_t neighbour;
+    int started;
+};
+
+/**
+ * \brief Shortest paths between all pairs of vertices of a graph
+ * 
+ * \note - Distances and next vertices of paths are computed once and recomputed only after the graph changes
+ * \note - Next vertices are kept in the narrowest unsigned integer type fitting the amount of vertices
+ */
+struct graph_paths;
+
+/**
+ * \brief Disk-backed graph
+ * 
+ * \note - Vertices and edges segments are files in a folder, read through a bounded cache of memory-mapped pages
+ * \note - Modifications are appended to a delta log and merged into segments periodically
+ */
+struct graph_disk;
+
 /**
  * \brief Data type for errors that occur during the operation of functions
  */
@@ -110,6 +299,19 @@ typedef int graph_error_t;
  */
 void graph_initialize(struct graph *graph);
 
+/**
+ * \brief Initialization of graph by zero with the given mode
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] mode `_GRAPH_DIRECTED__` / `_GRAPH_UNDIRECTED__`
+ * 
+ * \note - Undirected graph stores every edge once with the start vertex not greater (by `strcmp`) than the end vertex,
+ * edges are found by both orders of vertices, traversals and shortest paths go along edges in both directions
+ * \note - Incorrect mode gives directed graph
+ * \note - If the graph descriptor is NULL, the function will not cause a segmentation error
+ */
+void graph_initialize_mode(struct graph *graph, int mode);
+
 /**
  * \brief Checking for graph emtiness
  * 
@@ -157,6 +359,7 @@ int graph_has_edge(const struct graph *graph, const char *start_vertex, const ch
  * \note - You cannot add a copy of an existing vertex
  * \note - You cannot add a vertex with a name of zero length
  * \note - You cannot add a vertex with a name containing special characters - `#%()><{}-/\|:;,` and quotes
+ * \note - Inside a batch the vertex is only logged and `_GRAPH_EXIST__` is not reported
 */
 graph_error_t graph_add_vertex(struct graph *graph, const char *vertex);
 
@@ -167,6 +370,8 @@ graph_error_t graph_add_vertex(struct graph *graph, const char *vertex);
  * \param[in] vertex Vertex name
  * 
  * \return `_GRAPH_OK__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - Inside a batch the deletion is only logged, returning `_GRAPH_OK__` or `_GRAPH_MEM__`
 */
 graph_error_t graph_delete_vertex(struct graph *graph, const char *vertex);
 
@@ -181,6 +386,7 @@ graph_error_t graph_delete_vertex(struct graph *graph, const char *vertex);
  * 
  * \note - You cannot add a copy of an existing edge
  * \note - When adding an edge consisting of new vertices, new vertices will be added to the graph
+ * \note - Inside a batch the edge is only logged and `_GRAPH_EXIST__` is not reported
 */
 graph_error_t graph_add_edge(struct graph *graph, const char *start_vertex, const char *end_vertex, size_t edge_length);
 
@@ -192,9 +398,63 @@ graph_error_t graph_add_edge(struct graph *graph, const char *start_vertex, cons
  * \param[in] end_vertex End vertex name
  * 
  * \return `_GRAPH_OK__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - Inside a batch the deletion is only logged, returning `_GRAPH_OK__` or `_GRAPH_MEM__`
 */
 graph_error_t graph_delete_edge(struct graph *graph, const char *start_vertex, const char *end_vertex);
 
+/**
+ * \brief Opening a batch of modifications
+ * 
+ * \param[in] graph Graph descriptor
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EXIST__`
+ * 
+ * \note - Until the batch is committed or aborted, adding and deleting vertices and edges is only logged
+ * and the graph is seen by all other functions as it was before the batch
+ * \note - `_GRAPH_EXIST__` is returned if a batch is already open
+*/
+graph_error_t graph_batch_begin(struct graph *graph);
+
+/**
+ * \brief Applying logged modifications and closing the batch
+ * 
+ * \param[in] graph Graph descriptor
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - The result is the same as applying the modifications one by one in the logged order,
+ * modifications which would fail with `_GRAPH_EXIST__` or `_GRAPH_NOT_FOUND__` are skipped
+ * \note - On `_GRAPH_MEM__` nothing is applied and the batch stays open
+ * \note - `_GRAPH_NOT_FOUND__` is returned if no batch is open
+*/
+graph_error_t graph_batch_commit(struct graph *graph);
+
+/**
+ * \brief Discarding logged modifications and closing the batch
+ * 
+ * \param[in] graph Graph descriptor
+*/
+void graph_batch_abort(struct graph *graph);
+
+/**
+ * \brief Reordering vertices of graph for locality of traversals
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] strategy `_GRAPH_REORDER_RCM__` / `_GRAPH_REORDER_DEGREE__` / `_GRAPH_REORDER_BFS__`
+ * \param[out] permutation Array of `vertices_amount` new indexes of vertices (in the old order of `graph->vertices`),
+ * may be `NULL`
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`
+ * 
+ * \note - Orders are computed on edges of both directions, components are visited from their vertex of
+ * minimum degree (RCM) or from their first vertex (BFS)
+ * \note - Edges are sorted by new indexes of their start and end vertices
+ * \note - Adjacencies and distances derived from the graph are rebuilt in the new order on the next call,
+ * matrices created before must be mapped through `permutation`
+*/
+graph_error_t graph_reorder(struct graph *graph, int strategy, size_t *permutation);
+
 /**
  * \brief Draw graph using Graphviz and show it
  * 
@@ -208,6 +468,33 @@ graph_error_t graph_delete_edge(struct graph *graph, const char *start_vertex, c
 */
 graph_error_t graph_show(const struct graph *graph);
 
+/**
+ * \brief Resolving vertices of edges to their indexes
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[out] starts Array of `graph->edges_amount` indexes of start vertices (in the order of `graph->vertices`)
+ * \param[out] ends Array of `graph->edges_amount` indexes of end vertices (in the order of `graph->vertices`)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`
+ * 
+ * \note - Both indexes of an edge with a vertex not in the graph are `graph->vertices_amount`
+*/
+graph_error_t graph_edges_indexes(const struct graph *graph, size_t *starts, size_t *ends);
+
+/**
+ * \brief Drawing graph to SVG with layered layout
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] stream Output stream
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_OS_ERROR__`
+ * 
+ * \note - Layout is built in memory without external programs: cycles are broken by reversing edges, vertices are layered by
+ * longest paths, long edges are split by dummy nodes, crossings are reduced by barycentres and nodes are placed near neighbours
+ * \note - Reversed edges keep their directions in the drawing, undirected edges are drawn without arrows
+*/
+graph_error_t graph_render_svg(const struct graph *graph, FILE *stream);
+
 /**
  * \brief Creating a dot file by graph
  * 
@@ -313,6 +600,565 @@ void graph_adjacency_matrix_free(struct matrix *adjacency_matrix);
  */
 struct matrix *graph_floyd_warshall(const struct graph *graph);
 
+/**
+ * \brief Finding the shortest distances from a vertex using Dijkstra's algorithm
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] source Source vertex name
+ * \param[out] distances Array of `vertices_amount` distances (in the order of `graph->vertices`)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - Unreachable vertices get the `_GRAPH_INFINITY__` distance
+ */
+graph_error_t graph_dijkstra(const struct graph *graph, const char *source, size_t *distances);
+
+/**
+ * \brief Finding the shortest distances from a vertex using the parallel delta-stepping algorithm
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] source Source vertex name
+ * \param[in] delta Bucket width (`0` - chosen by the maximum edge length and the average degree)
+ * \param[in] threads_amount Amount of threads (`0` - amount of online processors)
+ * \param[out] distances Array of `vertices_amount` distances (in the order of `graph->vertices`)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`, `_GRAPH_OS_ERROR__`
+ * 
+ * \note - Edges not longer than `delta` are light and are relaxed repeatedly inside a bucket, heavy edges are relaxed once per bucket
+ * \note - Unreachable vertices get the `_GRAPH_INFINITY__` distance
+ * \note - The function uses POSIX threads, link with `-pthread`
+ */
+graph_error_t graph_delta_stepping(const struct graph *graph, const char *source, size_t delta, size_t threads_amount, size_t *distances);
+
+/**
+ * \brief Finding the shortest path between two vertices using bidirectional Dijkstra's algorithm
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] source Start vertex name
+ * \param[in] destination End vertex name
+ * \param[out] path Path descriptor
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - The search runs forward from the start vertex and backward from the end vertex and stops
+ * when the sum of both frontiers minimums is not less than the best path found
+ * \note - If the end vertex is unreachable, the function returns `_GRAPH_NOT_FOUND__`
+ * \note - The path must be freed using `graph_path_free`
+ */
+graph_error_t graph_shortest_path(const struct graph *graph, const char *source, const char *destination, struct graph_path *path);
+
+/**
+ * \brief Finding the shortest path between two vertices using the A* algorithm
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] source Start vertex name
+ * \param[in] destination End vertex name
+ * \param[in] heuristic Lower bound of the path length from a vertex to the end vertex
+ * \param[in] context User pointer passed to the heuristic function
+ * \param[out] path Path descriptor
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - The path is the shortest one if the heuristic never overestimates the remaining length
+ * \note - The heuristic is called at most once for every vertex
+ * \note - If the end vertex is unreachable, the function returns `_GRAPH_NOT_FOUND__`
+ * \note - The path must be freed using `graph_path_free`
+ */
+graph_error_t graph_shortest_path_astar(const struct graph *graph, const char *source, const char *destination, \
+    size_t (*heuristic)(const char *vertex, const char *destination, void *context), void *context, struct graph_path *path);
+
+/**
+ * \brief Free path
+ * 
+ * \param[in] path Path descriptor
+ */
+void graph_path_free(struct graph_path *path);
+
+/**
+ * \brief Creating shortest paths query descriptor for graph
+ * 
+ * \param[in] graph Graph descriptor
+ * 
+ * \return Shortest paths query descriptor
+ * 
+ * \note - If errors occur, the function returns NULL
+ * \note - The graph must outlive the descriptor, its modifications are detected by `generation`
+ * \note - Undirected graph keeps distances in the packed upper triangle of the matrix, paths are restored along edges
+ */
+struct graph_paths *graph_paths_create(const struct graph *graph);
+
+/**
+ * \brief Finding the shortest distance between two vertices
+ * 
+ * \param[in] paths Shortest paths query descriptor
+ * \param[in] source Start vertex name
+ * \param[in] destination End vertex name
+ * \param[out] distance Shortest distance
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - If the end vertex is unreachable, the distance is `_GRAPH_INFINITY__`
+ * \note - If the graph has changed, the shortest paths are recomputed before the query
+ */
+graph_error_t graph_paths_distance(struct graph_paths *paths, const char *source, const char *destination, size_t *distance);
+
+/**
+ * \brief Finding the shortest path between two vertices
+ * 
+ * \param[in] paths Shortest paths query descriptor
+ * \param[in] source Start vertex name
+ * \param[in] destination End vertex name
+ * \param[out] path Path descriptor
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - If the end vertex is unreachable, the function returns `_GRAPH_NOT_FOUND__`
+ * \note - If the graph has changed, the shortest paths are recomputed before the query
+ * \note - The path must be freed using `graph_path_free`
+ */
+graph_error_t graph_paths_path(struct graph_paths *paths, const char *source, const char *destination, struct graph_path *path);
+
+/**
+ * \brief Free shortest paths query descriptor
+ * 
+ * \param[in] paths Shortest paths query descriptor
+ */
+void graph_paths_free(struct graph_paths *paths);
+
+/**
+ * \brief Finding the minimum spanning forest of graph
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] algorithm `_GRAPH_MST_AUTO__`, `_GRAPH_MST_KRUSKAL__`, `_GRAPH_MST_PRIM__`, `_GRAPH_MST_BORUVKA__`
+ * \param[in] threads_amount Amount of threads (`0` - amount of online processors)
+ * \param[out] forest Spanning forest descriptor
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`
+ * 
+ * \note - Directions of edges are ignored
+ * \note - `_GRAPH_MST_AUTO__` chooses Prim's algorithm for dense graphs and Kruskal's algorithm otherwise
+ * \note - The forest must be freed using `graph_spanning_forest_free`
+ * \note - The function uses POSIX threads, link with `-pthread`
+ */
+graph_error_t graph_mst(const struct graph *graph, int algorithm, size_t threads_amount, struct graph_spanning_forest *forest);
+
+/**
+ * \brief Free spanning forest
+ * 
+ * \param[in] forest Spanning forest descriptor
+ */
+void graph_spanning_forest_free(struct graph_spanning_forest *forest);
+
+/**
+ * \brief Creating transition matrix by graph
+ * 
+ * \param[in] graph Graph descriptor
+ * 
+ * \return Sparse matrix descriptor
+ * 
+ * \note - Row `v` holds the in-edges of vertex `v`: the value in column `u` is `1 / out-degree(u)`
+ * \note - If errors occur, the function returns NULL
+ */
+struct sparse_matrix *graph_transition_matrix_create(const struct graph *graph);
+
+/**
+ * \brief Multiplication of sparse matrix by vector
+ * 
+ * \param[in] matrix Sparse matrix descriptor
+ * \param[in] vector Vector of `columns` values
+ * \param[out] result Vector of `rows` values
+ * \param[in] threads_amount Amount of threads (`0` - amount of online processors)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`
+ * 
+ * \note - Rows are split between threads into ranges with equal amounts of nonzero values
+ * \note - Threads are started only for large matrices, small products are computed by the calling thread
+ * \note - The function uses POSIX threads, link with `-pthread`
+ */
+graph_error_t graph_sparse_matrix_multiply(const struct sparse_matrix *matrix, const double *vector, double *result, size_t threads_amount);
+
+/**
+ * \brief Free sparse matrix
+ * 
+ * \param[in] matrix Sparse matrix descriptor
+ */
+void graph_sparse_matrix_free(struct sparse_matrix *matrix);
+
+/**
+ * \brief Ranking vertices of graph using the PageRank algorithm
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] damping Probability of following an edge (usually `0.85`)
+ * \param[in] tolerance Iterations stop when the sum of ranks changes is less than tolerance
+ * \param[in] max_iterations Max amount of iterations
+ * \param[in] threads_amount Amount of threads (`0` - amount of online processors)
+ * \param[out] ranks Array of `vertices_amount` ranks (in the order of `graph->vertices`)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`
+ * 
+ * \note - Ranks of vertices without out-edges are spread evenly between all vertices
+ * \note - The sum of ranks is `1`
+ * \note - The function uses POSIX threads, link with `-pthread`
+ */
+graph_error_t graph_pagerank(const struct graph *graph, double damping, double tolerance, size_t max_iterations, \
+    size_t threads_amount, double *ranks);
+
+/**
+ * \brief Betweenness centrality of vertices using the Brandes algorithm
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] samples_amount Amount of sampled sources (`0` - all vertices are sources)
+ * \param[in] threads_amount Amount of threads (`0` - amount of online processors)
+ * \param[out] centrality Array of `vertices_amount` centralities (in the order of `graph->vertices`)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`
+ * 
+ * \note - Centrality of a vertex is the sum over pairs of other vertices of the share of shortest paths passing through it
+ * \note - Shortest paths are found by breadth-first search if all edges have the same nonzero length, otherwise by Dijkstra
+ * \note - Edges of zero length must not form cycles (an undirected edge of zero length is a cycle), otherwise
+ * amounts of shortest paths are infinite and `_GRAPH_INCORRECT_ARG__` is returned
+ * \note - Sources are parallelized over threads, each thread accumulates its own centralities merged at the end
+ * \note - Sampled sources are chosen by a fixed pseudo-random sequence and the result is scaled by `vertices_amount / samples_amount`
+ * \note - In undirected mode every pair of vertices is counted once
+ * \note - The function uses POSIX threads, link with `-pthread`
+ */
+graph_error_t graph_betweenness(const struct graph *graph, size_t samples_amount, size_t threads_amount, double *centrality);
+
+/**
+ * \brief Creating empty compressed adjacency
+ * 
+ * \param[in] vertices_amount Amount of vertices
+ * 
+ * \return Compressed adjacency descriptor
+ * 
+ * \note - If errors occur, the function returns NULL
+ */
+struct graph_compressed *graph_compressed_create(size_t vertices_amount);
+
+/**
+ * \brief Adding neighbour list of a vertex to compressed adjacency
+ * 
+ * \param[in] compressed Compressed adjacency descriptor
+ * \param[in] vertex Vertex index
+ * \param[in] neighbours Array of neighbours indexes
+ * \param[in] lengths Array of edges lengths
+ * \param[in] neighbours_amount Length of neighbours and lengths arrays
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`
+ * 
+ * \note - Vertices must be added in increasing order, skipped vertices have no neighbours
+ * \note - Neighbours must be strictly increasing
+ */
+graph_error_t graph_compressed_append(struct graph_compressed *compressed, size_t vertex, const size_t *neighbours, \
+    const size_t *lengths, size_t neighbours_amount);
+
+/**
+ * \brief Creating compressed adjacency by graph
+ * 
+ * \param[in] graph Graph descriptor
+ * 
+ * \return Compressed adjacency descriptor
+ * 
+ * \note - Vertices indexes are in the order of `graph->vertices`
+ * \note - If errors occur, the function returns NULL
+ */
+struct graph_compressed *graph_compressed_from_graph(const struct graph *graph);
+
+/**
+ * \brief Starting iteration over neighbours of a vertex
+ * 
+ * \param[in] compressed Compressed adjacency descriptor
+ * \param[in] vertex Vertex index
+ * \param[out] iterator Iterator descriptor
+ * 
+ * \note - If the arguments are incorrect, the iterator has no neighbours
+ */
+void graph_compressed_iterator_init(const struct graph_compressed *compressed, size_t vertex, struct graph_compressed_iterator *iterator);
+
+/**
+ * \brief Decoding the next neighbour
+ * 
+ * \param[in] iterator Iterator descriptor
+ * \param[out] neighbour Neighbour index
+ * \param[out] length Edge length (can be NULL)
+ * 
+ * \return `1` - neighbour is decoded / `0` - no neighbours left
+ */
+int graph_compressed_iterator_next(struct graph_compressed_iterator *iterator, size_t *neighbour, size_t *length);
+
+/**
+ * \brief Checking for the presence of a edge in compressed adjacency
+ * 
+ * \param[in] compressed Compressed adjacency descriptor
+ * \param[in] start_vertex Start vertex index
+ * \param[in] end_vertex End vertex index
+ * 
+ * \return `1` - `True` / `0` - `False`
+ * 
+ * \note - Samples are binary searched, so at most 64 neighbours are decoded
+ * \note - If incorrect arguments are passed, the function returns `0` (`False`)
+ */
+int graph_compressed_has_edge(const struct graph_compressed *compressed, size_t start_vertex, size_t end_vertex);
+
+/**
+ * \brief Graph traversal over compressed adjacency using a breadth-first search algorithm
+ * 
+ * \param[in] compressed Compressed adjacency descriptor
+ * \param[in] source Source vertex index
+ * \param[in] vertex_processing Vertex processing function
+ * \param[in] context User pointer passed to the vertex processing function
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`
+ */
+graph_error_t graph_compressed_bfs(const struct graph_compressed *compressed, size_t source, \
+    void (*vertex_processing)(size_t vertex, void *context), void *context);
+
+/**
+ * \brief Counting the memory used by compressed adjacency
+ * 
+ * \param[in] compressed Compressed adjacency descriptor
+ * 
+ * \return Size in bytes
+ */
+size_t graph_compressed_size(const struct graph_compressed *compressed);
+
+/**
+ * \brief Free compressed adjacency
+ * 
+ * \param[in] compressed Compressed adjacency descriptor
+ */
+void graph_compressed_free(struct graph_compressed *compressed);
+
+/**
+ * \brief Writing graph to a folder as disk-backed graph
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] folder Folder name
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_OS_ERROR__`
+ * 
+ * \note - The folder is created if it does not exist, an existing disk-backed graph in it is replaced
+ * \note - An empty graph creates an empty disk-backed graph to be filled by modifications
+ * \note - Edges of undirected graph are written in both directions, the mode is kept with the graph
+ */
+graph_error_t graph_disk_create(const struct graph *graph, const char *folder);
+
+/**
+ * \brief Opening disk-backed graph
+ * 
+ * \param[in] folder Folder name
+ * \param[in] cache_pages Max amount of memory-mapped pages of 1 MiB (at least 4 are used)
+ * 
+ * \return Disk-backed graph descriptor
+ * 
+ * \note - Modifications from the delta log are replayed
+ * \note - If errors occur, the function returns NULL
+ */
+struct graph_disk *graph_disk_open(const char *folder, size_t cache_pages);
+
+/**
+ * \brief Counting vertices of disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * 
+ * \return Amount of vertices
+ */
+size_t graph_disk_vertices_amount(const struct graph_disk *disk);
+
+/**
+ * \brief Reading vertex name of disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] index Vertex index
+ * \param[out] vertex Buffer of `_STRING__ + 1` characters
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`, `_GRAPH_OS_ERROR__`
+ */
+graph_error_t graph_disk_vertex(struct graph_disk *disk, size_t index, char *vertex);
+
+/**
+ * \brief Checking for the presence of a edge in disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] start_vertex Start vertex name
+ * \param[in] end_vertex End vertex name
+ * 
+ * \return `1` - `True` / `0` - `False`
+ * 
+ * \note - If incorrect arguments are passed, the function returns `0` (`False`)
+ */
+int graph_disk_has_edge(struct graph_disk *disk, const char *start_vertex, const char *end_vertex);
+
+/**
+ * \brief Adding a vertex to disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] vertex Vertex name
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EXIST__`, `_GRAPH_OS_ERROR__`
+ */
+graph_error_t graph_disk_add_vertex(struct graph_disk *disk, const char *vertex);
+
+/**
+ * \brief Adding an edge to disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] start_vertex Start vertex name
+ * \param[in] end_vertex End vertex name
+ * \param[in] edge_length Length of edge
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EXIST__`, `_GRAPH_OS_ERROR__`
+ * 
+ * \note - When adding an edge consisting of new vertices, new vertices will be added to the graph
+ * \note - In undirected mode the edge is added in both directions
+ */
+graph_error_t graph_disk_add_edge(struct graph_disk *disk, const char *start_vertex, const char *end_vertex, size_t edge_length);
+
+/**
+ * \brief Deleting edge from disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] start_vertex Start vertex name
+ * \param[in] end_vertex End vertex name
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`, `_GRAPH_OS_ERROR__`
+ * 
+ * \note - In undirected mode the edge is deleted in both directions
+ */
+graph_error_t graph_disk_delete_edge(struct graph_disk *disk, const char *start_vertex, const char *end_vertex);
+
+/**
+ * \brief Merging the delta log into segments of disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_OS_ERROR__`
+ * 
+ * \note - Segments are rewritten sequentially and replace the old ones, then the log is emptied
+ * \note - Merge runs automatically when the log holds too many modifications
+ */
+graph_error_t graph_disk_merge(struct graph_disk *disk);
+
+/**
+ * \brief Disk-backed graph traversal using a breadth-first search algorithm
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] source Source vertex name
+ * \param[in] vertex_processing Vertex processing function
+ * \param[in] context User pointer passed to the vertex processing function
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`, `_GRAPH_OS_ERROR__`
+ */
+graph_error_t graph_disk_bfs(struct graph_disk *disk, const char *source, \
+    void (*vertex_processing)(const char *vertex_name, void *context), void *context);
+
+/**
+ * \brief Disk-backed graph traversal using a depth-first search algorithm
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] source Source vertex name
+ * \param[in] vertex_processing Vertex processing function
+ * \param[in] context User pointer passed to the vertex processing function
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`, `_GRAPH_OS_ERROR__`
+ */
+graph_error_t graph_disk_dfs(struct graph_disk *disk, const char *source, \
+    void (*vertex_processing)(const char *vertex_name, void *context), void *context);
+
+/**
+ * \brief Finding the shortest distances from a vertex of disk-backed graph using Dijkstra's algorithm
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ * \param[in] source Source vertex name
+ * \param[out] distances Array of `graph_disk_vertices_amount` distances
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_NOT_FOUND__`, `_GRAPH_OS_ERROR__`
+ * 
+ * \note - Unreachable vertices get the `_GRAPH_INFINITY__` distance
+ */
+graph_error_t graph_disk_dijkstra(struct graph_disk *disk, const char *source, size_t *distances);
+
+/**
+ * \brief Close disk-backed graph
+ * 
+ * \param[in] disk Disk-backed graph descriptor
+ */
+void graph_disk_close(struct graph_disk *disk);
+
+/**
+ * \brief Searching vertices reachable from the source within `k` hops
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] source Source vertex name
+ * \param[in] k Max amount of hops
+ * \param[out] neighbourhood Neighbourhood descriptor (vertices in breadth-first order, the source first)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - The query runs on the workspace of the calling thread, its cost is proportional to the visited vertices
+ * \note - The workspace indexes the graph again only after its modifications (detected by `generation`)
+ */
+graph_error_t graph_k_hop(const struct graph *graph, const char *source, size_t k, struct graph_neighbourhood *neighbourhood);
+
+/**
+ * \brief Free neighbourhood
+ * 
+ * \param[in] neighbourhood Neighbourhood descriptor
+ */
+void graph_neighbourhood_free(struct graph_neighbourhood *neighbourhood);
+
+/**
+ * \brief Extracting subgraph induced by vertices
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] vertices Array of vertices indexes (in the order of `graph->vertices`)
+ * \param[in] vertices_amount Length of vertices array
+ * \param[out] subgraph Subgraph descriptor (initialized by the function)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`
+ * 
+ * \note - Subgraph contains the vertices and all edges of the graph between them, repeated indexes are skipped
+ * \note - The extraction runs on the workspace of the calling thread, its cost is proportional to the edges of the vertices
+ * \note - If errors occur, the subgraph is left empty
+ */
+graph_error_t graph_induced_subgraph(const struct graph *graph, const size_t *vertices, size_t vertices_amount, struct graph *subgraph);
+
+/**
+ * \brief Breadth-first search from several sources at once
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] sources Array of sources names
+ * \param[in] sources_amount Length of sources array
+ * \param[out] distances Matrix of `sources_amount` rows of `graph->vertices_amount` hops (in the order of `graph->vertices`)
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ * 
+ * \note - Up to `_GRAPH_MS_BFS_SOURCES__` sources are searched together with one scan of edges per level
+ * \note - Unreachable vertices get `_GRAPH_INFINITY__`
+ */
+graph_error_t graph_ms_bfs(const struct graph *graph, const char **sources, size_t sources_amount, size_t *distances);
+
+/**
+ * \brief Breadth-first search from several sources at once with processing of reached vertices
+ * 
+ * \param[in] graph Graph descriptor
+ * \param[in] sources Array of sources names
+ * \param[in] sources_amount Length of sources array
+ * \param[in] vertex_processing Function called for every source index, reached vertex index and hops (in the order of hops)
+ * \param[in] context Argument passed to the function
+ * 
+ * \return `_GRAPH_OK__`, `_GRAPH_MEM__`, `_GRAPH_INCORRECT_ARG__`, `_GRAPH_EMPTY__`, `_GRAPH_NOT_FOUND__`
+ */
+graph_error_t graph_ms_bfs_stream(const struct graph *graph, const char **sources, size_t sources_amount, \
+    void (*vertex_processing)(size_t source, size_t vertex, size_t hops, void *context), void *context);
+
+/**
+ * \brief Free workspace of the calling thread
+ * 
+ * \note - Workspaces are freed automatically when threads exit, the function releases memory earlier
+ */
+void graph_workspace_free(void);
+
 /**
  * \brief Free graph
  * 
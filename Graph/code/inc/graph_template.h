@@ -0,0 +1,522 @@
+#ifndef GRAPH_TEMPLATE_H__
+#define GRAPH_TEMPLATE_H__
+
+#include <stdlib.h>
+#include <string.h>
+#include "graph.h"
+
+// Macro
+
+/**
+ * \brief Declaring weighted graph variant
+ * 
+ * \param name Name of the variant structure and prefix of its functions
+ * \param id_type Unsigned integer type of vertices indexes
+ * \param weight_type Type of edges weights (unsigned integer or floating point)
+ * \param distance_type Type of distances, wide enough for sums of weights (`uint64_t` or `double`)
+ * 
+ * \note - Generates `struct name` with adjacency rows in `offsets` and `targets` and weights in `weights`
+ * \note - Generates `name##_create`, `name##_from_graph`, `name##_distances`, `name##_floyd_warshall` and `name##_free`
+*/
+#define _GRAPH_TEMPLATE_DECLARE_WEIGHTED__(name, id_type, weight_type, distance_type)                                   \
+struct name                                                                                                             \
+{                                                                                                                       \
+    size_t vertices_amount;                                                                                             \
+    size_t edges_amount;                                                                                                \
+    size_t *offsets;                                                                                                    \
+    id_type *targets;                                                                                                   \
+    weight_type *weights;                                                                                               \
+};                                                                                                                      \
+                                                                                                                        \
+graph_error_t name##_create(struct name *variant, size_t vertices_amount, size_t edges_amount,                          \
+                           const id_type *starts, const id_type *ends, const weight_type *weights);                     \
+graph_error_t name##_from_graph(const struct graph *graph, struct name *variant);                                       \
+graph_error_t name##_distances(const struct name *variant, size_t source, distance_type *distances);                    \
+graph_error_t name##_floyd_warshall(const struct name *variant, distance_type *distances);                              \
+void name##_free(struct name *variant);
+
+/**
+ * \brief Declaring unweighted graph variant
+ * 
+ * \param name Name of the variant structure and prefix of its functions
+ * \param id_type Unsigned integer type of vertices indexes (also the type of hops amounts)
+ * 
+ * \note - Generates the same functions as `_GRAPH_TEMPLATE_DECLARE_WEIGHTED__` without weights array,
+ * distances are amounts of hops
+*/
+#define _GRAPH_TEMPLATE_DECLARE_UNWEIGHTED__(name, id_type)                                                             \
+struct name                                                                                                             \
+{                                                                                                                       \
+    size_t vertices_amount;                                                                                             \
+    size_t edges_amount;                                                                                                \
+    size_t *offsets;                                                                                                    \
+    id_type *targets;                                                                                                   \
+};                                                                                                                      \
+                                                                                                                        \
+graph_error_t name##_create(struct name *variant, size_t vertices_amount, size_t edges_amount,                          \
+                           const id_type *starts, const id_type *ends);                                                 \
+graph_error_t name##_from_graph(const struct graph *graph, struct name *variant);                                       \
+graph_error_t name##_distances(const struct name *variant, size_t source, id_type *distances);                          \
+graph_error_t name##_floyd_warshall(const struct name *variant, id_type *distances);                                    \
+void name##_free(struct name *variant);
+
+/**
+ * \brief Generating code shared by weighted and unweighted variants
+ * 
+ * \note - Expects `name##_weight` to be defined before
+*/
+#define _GRAPH_TEMPLATE_COMMON__(name, id_type, distance_type, infinity)                                                \
+static graph_error_t name##_rows_create(struct name *variant, size_t vertices_amount, size_t edges_amount,              \
+                                        const id_type *starts, const id_type *ends, size_t **cursors)                   \
+{                                                                                                                       \
+    if (!variant || ((!starts || !ends) && edges_amount) || vertices_amount > (size_t) (id_type) ~(id_type) 0)          \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    for (size_t i = 0; i < edges_amount; i++)                                                                           \
+        if (starts[i] >= vertices_amount || ends[i] >= vertices_amount)                                                 \
+            return _GRAPH_INCORRECT_ARG__;                                                                              \
+                                                                                                                        \
+    memset(variant, 0, sizeof(struct name));                                                                            \
+                                                                                                                        \
+    variant->offsets = calloc(vertices_amount + 1, sizeof(size_t));                                                     \
+    variant->targets = malloc((edges_amount + 1) * sizeof(id_type));                                                    \
+    *cursors = malloc((vertices_amount + 1) * sizeof(size_t));                                                          \
+                                                                                                                        \
+    if (!variant->offsets || !variant->targets || !*cursors)                                                            \
+    {                                                                                                                   \
+        free(variant->offsets);                                                                                         \
+        free(variant->targets);                                                                                         \
+        free(*cursors);                                                                                                 \
+        variant->offsets = NULL;                                                                                        \
+        variant->targets = NULL;                                                                                        \
+        return _GRAPH_MEM__;                                                                                            \
+    }                                                                                                                   \
+                                                                                                                        \
+    variant->vertices_amount = vertices_amount;                                                                         \
+    variant->edges_amount = edges_amount;                                                                               \
+                                                                                                                        \
+    for (size_t i = 0; i < edges_amount; i++)                                                                           \
+        variant->offsets[starts[i] + 1]++;                                                                              \
+                                                                                                                        \
+    for (size_t i = 0; i < vertices_amount; i++)                                                                        \
+        variant->offsets[i + 1] += variant->offsets[i];                                                                 \
+                                                                                                                        \
+    memcpy(*cursors, variant->offsets, (vertices_amount + 1) * sizeof(size_t));                                         \
+                                                                                                                        \
+    return _GRAPH_OK__;                                                                                                 \
+}                                                                                                                       \
+                                                                                                                        \
+static graph_error_t name##_edges_create(const struct graph *graph, id_type **starts, id_type **ends,                   \
+                                         size_t **indexes, size_t *edges_amount)                                        \
+{                                                                                                                       \
+    if (!graph || graph->vertices_amount > (size_t) (id_type) ~(id_type) 0)                                             \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    graph_error_t rc = _GRAPH_OK__;                                                                                     \
+                                                                                                                        \
+    size_t *resolved_starts = malloc((graph->edges_amount + 1) * sizeof(size_t));                                       \
+    size_t *resolved_ends = malloc((graph->edges_amount + 1) * sizeof(size_t));                                         \
+                                                                                                                        \
+    *starts = malloc((2 * graph->edges_amount + 1) * sizeof(id_type));                                                  \
+    *ends = malloc((2 * graph->edges_amount + 1) * sizeof(id_type));                                                    \
+    *indexes = malloc((2 * graph->edges_amount + 1) * sizeof(size_t));                                                  \
+    *edges_amount = 0;                                                                                                  \
+                                                                                                                        \
+    if (!resolved_starts || !resolved_ends || !*starts || !*ends || !*indexes)                                          \
+        rc = _GRAPH_MEM__;                                                                                              \
+                                                                                                                        \
+    if (rc == _GRAPH_OK__)                                                                                              \
+        rc = graph_edges_indexes(graph, resolved_starts, resolved_ends);                                                \
+                                                                                                                        \
+    for (size_t i = 0; rc == _GRAPH_OK__ && i < graph->edges_amount; i++)                                               \
+    {                                                                                                                   \
+        if (resolved_starts[i] == graph->vertices_amount)                                                               \
+            continue;                                                                                                   \
+                                                                                                                        \
+        (*starts)[*edges_amount] = (id_type) resolved_starts[i];                                                        \
+        (*ends)[*edges_amount] = (id_type) resolved_ends[i];                                                            \
+        (*indexes)[(*edges_amount)++] = i;                                                                              \
+                                                                                                                        \
+        /* undirected edges are walked both ways, loops once */                                                         \
+                                                                                                                        \
+        if (graph->mode == _GRAPH_UNDIRECTED__ && resolved_starts[i] != resolved_ends[i])                               \
+        {                                                                                                               \
+            (*starts)[*edges_amount] = (id_type) resolved_ends[i];                                                      \
+            (*ends)[*edges_amount] = (id_type) resolved_starts[i];                                                      \
+            (*indexes)[(*edges_amount)++] = i;                                                                          \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    free(resolved_starts);                                                                                              \
+    free(resolved_ends);                                                                                                \
+                                                                                                                        \
+    if (rc != _GRAPH_OK__)                                                                                              \
+    {                                                                                                                   \
+        free(*starts);                                                                                                  \
+        free(*ends);                                                                                                    \
+        free(*indexes);                                                                                                 \
+        *starts = *ends = NULL;                                                                                         \
+        *indexes = NULL;                                                                                                \
+    }                                                                                                                   \
+                                                                                                                        \
+    return rc;                                                                                                          \
+}                                                                                                                       \
+                                                                                                                        \
+graph_error_t name##_floyd_warshall(const struct name *variant, distance_type *distances)                               \
+{                                                                                                                       \
+    if (!variant || !distances)                                                                                         \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    size_t vertices_amount = variant->vertices_amount;                                                                  \
+                                                                                                                        \
+    for (size_t i = 0; i < vertices_amount * vertices_amount; i++)                                                      \
+        distances[i] = infinity;                                                                                        \
+                                                                                                                        \
+    for (size_t i = 0; i < vertices_amount; i++)                                                                        \
+    {                                                                                                                   \
+        distances[i * vertices_amount + i] = 0;                                                                         \
+                                                                                                                        \
+        for (size_t j = variant->offsets[i]; j < variant->offsets[i + 1]; j++)                                          \
+        {                                                                                                               \
+            distance_type weight = name##_weight(variant, j);                                                           \
+            size_t position = i * vertices_amount + variant->targets[j];                                                \
+                                                                                                                        \
+            if (weight < distances[position])                                                                           \
+                distances[position] = weight;                                                                           \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    for (size_t k = 0; k < vertices_amount; k++)                                                                        \
+    {                                                                                                                   \
+        const distance_type *row_k = distances + k * vertices_amount;                                                   \
+                                                                                                                        \
+        for (size_t i = 0; i < vertices_amount; i++)                                                                    \
+        {                                                                                                               \
+            distance_type *row_i = distances + i * vertices_amount;                                                     \
+            distance_type distance_ik = row_i[k];                                                                       \
+                                                                                                                        \
+            if (distance_ik == infinity || i == k)                                                                      \
+                continue;                                                                                               \
+                                                                                                                        \
+            for (size_t j = 0; j < vertices_amount; j++)                                                                \
+                if (row_k[j] < infinity - distance_ik && distance_ik + row_k[j] < row_i[j])                             \
+                    row_i[j] = distance_ik + row_k[j];                                                                  \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    return _GRAPH_OK__;                                                                                                 \
+}
+
+/**
+ * \brief Defining functions of weighted graph variant
+ * 
+ * \param name Name given to `_GRAPH_TEMPLATE_DECLARE_WEIGHTED__`
+ * \param id_type Unsigned integer type of vertices indexes
+ * \param weight_type Type of edges weights
+ * \param distance_type Type of distances given to `_GRAPH_TEMPLATE_DECLARE_WEIGHTED__`
+ * \param infinity Distance of `distance_type` to unreachable vertices, weights must be less than it
+ * 
+ * \note - Distances are computed by Dijkstra with a lazy binary heap of `distance_type` keys
+ * \note - Sums reaching `infinity` are treated as unreachable instead of overflowing
+*/
+#define _GRAPH_TEMPLATE_DEFINE_WEIGHTED__(name, id_type, weight_type, distance_type, infinity)                          \
+static inline weight_type name##_weight(const struct name *variant, size_t position)                                    \
+{                                                                                                                       \
+    return variant->weights[position];                                                                                  \
+}                                                                                                                       \
+                                                                                                                        \
+_GRAPH_TEMPLATE_COMMON__(name, id_type, distance_type, infinity)                                                        \
+                                                                                                                        \
+graph_error_t name##_create(struct name *variant, size_t vertices_amount, size_t edges_amount,                          \
+                           const id_type *starts, const id_type *ends, const weight_type *weights)                      \
+{                                                                                                                       \
+    if (!weights && edges_amount)                                                                                       \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    /* negative, infinite and NaN weights are rejected */                                                               \
+                                                                                                                        \
+    for (size_t i = 0; i < edges_amount; i++)                                                                           \
+        if (!((distance_type) weights[i] < infinity)                                                                    \
+            || (weights[i] <= (weight_type) 0 && weights[i] != (weight_type) 0))                                        \
+            return _GRAPH_INCORRECT_ARG__;                                                                              \
+                                                                                                                        \
+    size_t *cursors = NULL;                                                                                             \
+                                                                                                                        \
+    graph_error_t rc = name##_rows_create(variant, vertices_amount, edges_amount, starts, ends, &cursors);              \
+                                                                                                                        \
+    if (rc == _GRAPH_OK__)                                                                                              \
+    {                                                                                                                   \
+        variant->weights = malloc((edges_amount + 1) * sizeof(weight_type));                                            \
+        if (!variant->weights)                                                                                          \
+        {                                                                                                               \
+            name##_free(variant);                                                                                       \
+            rc = _GRAPH_MEM__;                                                                                          \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    for (size_t i = 0; rc == _GRAPH_OK__ && i < edges_amount; i++)                                                      \
+    {                                                                                                                   \
+        size_t position = cursors[starts[i]]++;                                                                         \
+                                                                                                                        \
+        variant->targets[position] = ends[i];                                                                           \
+        variant->weights[position] = weights[i];                                                                        \
+    }                                                                                                                   \
+                                                                                                                        \
+    free(cursors);                                                                                                      \
+                                                                                                                        \
+    return rc;                                                                                                          \
+}                                                                                                                       \
+                                                                                                                        \
+graph_error_t name##_from_graph(const struct graph *graph, struct name *variant)                                        \
+{                                                                                                                       \
+    if (!graph || !variant)                                                                                             \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    id_type *starts = NULL;                                                                                             \
+    id_type *ends = NULL;                                                                                               \
+    size_t *indexes = NULL;                                                                                             \
+    size_t edges_amount = 0;                                                                                            \
+                                                                                                                        \
+    graph_error_t rc = name##_edges_create(graph, &starts, &ends, &indexes, &edges_amount);                             \
+                                                                                                                        \
+    weight_type *weights = NULL;                                                                                        \
+                                                                                                                        \
+    if (rc == _GRAPH_OK__)                                                                                              \
+    {                                                                                                                   \
+        weights = malloc((edges_amount + 1) * sizeof(weight_type));                                                     \
+        if (!weights)                                                                                                   \
+            rc = _GRAPH_MEM__;                                                                                          \
+    }                                                                                                                   \
+                                                                                                                        \
+    for (size_t i = 0; rc == _GRAPH_OK__ && i < edges_amount; i++)                                                      \
+    {                                                                                                                   \
+        size_t length = graph->edges[indexes[i]].length;                                                                \
+                                                                                                                        \
+        /* lengths truncated by integer weights are rejected, floating point ones are rounded */                        \
+                                                                                                                        \
+        if ((long double) length >= (long double) (infinity) || (weight_type) length != length)                         \
+            rc = _GRAPH_INCORRECT_ARG__;                                                                                \
+        else                                                                                                            \
+            weights[i] = (weight_type) length;                                                                          \
+    }                                                                                                                   \
+                                                                                                                        \
+    if (rc == _GRAPH_OK__)                                                                                              \
+        rc = name##_create(variant, graph->vertices_amount, edges_amount, starts, ends, weights);                       \
+                                                                                                                        \
+    free(starts);                                                                                                       \
+    free(ends);                                                                                                         \
+    free(indexes);                                                                                                      \
+    free(weights);                                                                                                      \
+                                                                                                                        \
+    return rc;                                                                                                          \
+}                                                                                                                       \
+                                                                                                                        \
+struct name##_heap_node                                                                                                 \
+{                                                                                                                       \
+    distance_type distance;                                                                                             \
+    id_type vertex;                                                                                                     \
+};                                                                                                                      \
+                                                                                                                        \
+static inline void name##_heap_push(struct name##_heap_node *heap, size_t *size, struct name##_heap_node node)          \
+{                                                                                                                       \
+    size_t i = (*size)++;                                                                                               \
+                                                                                                                        \
+    while (i > 0 && node.distance < heap[(i - 1) / 2].distance)                                                         \
+    {                                                                                                                   \
+        heap[i] = heap[(i - 1) / 2];                                                                                    \
+        i = (i - 1) / 2;                                                                                                \
+    }                                                                                                                   \
+                                                                                                                        \
+    heap[i] = node;                                                                                                     \
+}                                                                                                                       \
+                                                                                                                        \
+static inline struct name##_heap_node name##_heap_pop(struct name##_heap_node *heap, size_t *size)                      \
+{                                                                                                                       \
+    struct name##_heap_node top = heap[0];                                                                              \
+    struct name##_heap_node last = heap[--(*size)];                                                                     \
+    size_t i = 0;                                                                                                       \
+                                                                                                                        \
+    while (2 * i + 1 < *size)                                                                                           \
+    {                                                                                                                   \
+        size_t child = 2 * i + 1;                                                                                       \
+                                                                                                                        \
+        if (child + 1 < *size && heap[child + 1].distance < heap[child].distance)                                       \
+            child++;                                                                                                    \
+                                                                                                                        \
+        if (!(heap[child].distance < last.distance))                                                                    \
+            break;                                                                                                      \
+                                                                                                                        \
+        heap[i] = heap[child];                                                                                          \
+        i = child;                                                                                                      \
+    }                                                                                                                   \
+                                                                                                                        \
+    heap[i] = last;                                                                                                     \
+                                                                                                                        \
+    return top;                                                                                                         \
+}                                                                                                                       \
+                                                                                                                        \
+graph_error_t name##_distances(const struct name *variant, size_t source, distance_type *distances)                     \
+{                                                                                                                       \
+    if (!variant || !distances || source >= variant->vertices_amount)                                                   \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    /* every relaxation pushes at most one node, so edges amount bounds the heap */                                     \
+                                                                                                                        \
+    struct name##_heap_node *heap = malloc((variant->edges_amount + 1) * sizeof(struct name##_heap_node));              \
+    if (!heap)                                                                                                          \
+        return _GRAPH_MEM__;                                                                                            \
+                                                                                                                        \
+    for (size_t i = 0; i < variant->vertices_amount; i++)                                                               \
+        distances[i] = infinity;                                                                                        \
+                                                                                                                        \
+    size_t size = 0;                                                                                                    \
+                                                                                                                        \
+    distances[source] = 0;                                                                                              \
+    name##_heap_push(heap, &size, (struct name##_heap_node) { 0, (id_type) source });                                   \
+                                                                                                                        \
+    while (size)                                                                                                        \
+    {                                                                                                                   \
+        struct name##_heap_node node = name##_heap_pop(heap, &size);                                                    \
+                                                                                                                        \
+        if (distances[node.vertex] < node.distance)                                                                     \
+            continue;                                                                                                   \
+                                                                                                                        \
+        for (size_t j = variant->offsets[node.vertex]; j < variant->offsets[node.vertex + 1]; j++)                      \
+        {                                                                                                               \
+            distance_type weight = variant->weights[j];                                                                 \
+            id_type target = variant->targets[j];                                                                       \
+                                                                                                                        \
+            if (weight < infinity - node.distance && node.distance + weight < distances[target])                        \
+            {                                                                                                           \
+                distances[target] = node.distance + weight;                                                             \
+                name##_heap_push(heap, &size, (struct name##_heap_node) { distances[target], target });                 \
+            }                                                                                                           \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    free(heap);                                                                                                         \
+                                                                                                                        \
+    return _GRAPH_OK__;                                                                                                 \
+}                                                                                                                       \
+                                                                                                                        \
+void name##_free(struct name *variant)                                                                                  \
+{                                                                                                                       \
+    if (!variant)                                                                                                       \
+        return;                                                                                                         \
+                                                                                                                        \
+    free(variant->offsets);                                                                                             \
+    free(variant->targets);                                                                                             \
+    free(variant->weights);                                                                                             \
+                                                                                                                        \
+    memset(variant, 0, sizeof(struct name));                                                                            \
+}
+
+/**
+ * \brief Defining functions of unweighted graph variant
+ * 
+ * \param name Name given to `_GRAPH_TEMPLATE_DECLARE_UNWEIGHTED__`
+ * \param id_type Unsigned integer type of vertices indexes
+ * \param infinity Amount of hops to unreachable vertices
+ * 
+ * \note - Distances are computed by breadth-first search, every edge is one hop
+*/
+#define _GRAPH_TEMPLATE_DEFINE_UNWEIGHTED__(name, id_type, infinity)                                                    \
+static inline id_type name##_weight(const struct name *variant, size_t position)                                        \
+{                                                                                                                       \
+    (void) variant;                                                                                                     \
+    (void) position;                                                                                                    \
+                                                                                                                        \
+    return 1;                                                                                                           \
+}                                                                                                                       \
+                                                                                                                        \
+_GRAPH_TEMPLATE_COMMON__(name, id_type, id_type, infinity)                                                              \
+                                                                                                                        \
+graph_error_t name##_create(struct name *variant, size_t vertices_amount, size_t edges_amount,                          \
+                           const id_type *starts, const id_type *ends)                                                  \
+{                                                                                                                       \
+    size_t *cursors = NULL;                                                                                             \
+                                                                                                                        \
+    graph_error_t rc = name##_rows_create(variant, vertices_amount, edges_amount, starts, ends, &cursors);              \
+                                                                                                                        \
+    for (size_t i = 0; rc == _GRAPH_OK__ && i < edges_amount; i++)                                                      \
+        variant->targets[cursors[starts[i]]++] = ends[i];                                                               \
+                                                                                                                        \
+    free(cursors);                                                                                                      \
+                                                                                                                        \
+    return rc;                                                                                                          \
+}                                                                                                                       \
+                                                                                                                        \
+graph_error_t name##_from_graph(const struct graph *graph, struct name *variant)                                        \
+{                                                                                                                       \
+    if (!graph || !variant)                                                                                             \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    id_type *starts = NULL;                                                                                             \
+    id_type *ends = NULL;                                                                                               \
+    size_t *indexes = NULL;                                                                                             \
+    size_t edges_amount = 0;                                                                                            \
+                                                                                                                        \
+    graph_error_t rc = name##_edges_create(graph, &starts, &ends, &indexes, &edges_amount);                             \
+                                                                                                                        \
+    if (rc == _GRAPH_OK__)                                                                                              \
+        rc = name##_create(variant, graph->vertices_amount, edges_amount, starts, ends);                                \
+                                                                                                                        \
+    free(starts);                                                                                                       \
+    free(ends);                                                                                                         \
+    free(indexes);                                                                                                      \
+                                                                                                                        \
+    return rc;                                                                                                          \
+}                                                                                                                       \
+                                                                                                                        \
+graph_error_t name##_distances(const struct name *variant, size_t source, id_type *distances)                           \
+{                                                                                                                       \
+    if (!variant || !distances || source >= variant->vertices_amount)                                                   \
+        return _GRAPH_INCORRECT_ARG__;                                                                                  \
+                                                                                                                        \
+    id_type *queue = malloc(variant->vertices_amount * sizeof(id_type));                                                \
+    if (!queue)                                                                                                         \
+        return _GRAPH_MEM__;                                                                                            \
+                                                                                                                        \
+    for (size_t i = 0; i < variant->vertices_amount; i++)                                                               \
+        distances[i] = infinity;                                                                                        \
+                                                                                                                        \
+    size_t head = 0;                                                                                                    \
+    size_t tail = 0;                                                                                                    \
+                                                                                                                        \
+    distances[source] = 0;                                                                                              \
+    queue[tail++] = (id_type) source;                                                                                   \
+                                                                                                                        \
+    while (head < tail)                                                                                                 \
+    {                                                                                                                   \
+        id_type vertex = queue[head++];                                                                                 \
+                                                                                                                        \
+        for (size_t j = variant->offsets[vertex]; j < variant->offsets[vertex + 1]; j++)                                \
+        {                                                                                                               \
+            id_type target = variant->targets[j];                                                                       \
+                                                                                                                        \
+            if (distances[target] == infinity)                                                                          \
+            {                                                                                                           \
+                distances[target] = distances[vertex] + 1;                                                              \
+                queue[tail++] = target;                                                                                 \
+            }                                                                                                           \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    free(queue);                                                                                                        \
+                                                                                                                        \
+    return _GRAPH_OK__;                                                                                                 \
+}                                                                                                                       \
+                                                                                                                        \
+void name##_free(struct name *variant)                                                                                  \
+{                                                                                                                       \
+    if (!variant)                                                                                                       \
+        return;                                                                                                         \
+                                                                                                                        \
+    free(variant->offsets);                                                                                             \
+    free(variant->targets);                                                                                             \
+                                                                                                                        \
+    memset(variant, 0, sizeof(struct name));                                                                            \
+}
+
+#endif // GRAPH_TEMPLATE_H__
+
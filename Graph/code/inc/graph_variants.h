@@ -0,0 +1,38 @@
+#ifndef GRAPH_VARIANTS_H__
+#define GRAPH_VARIANTS_H__
+
+#include "graph_template.h"
+
+// Variants
+
+/**
+ * \brief Unweighted graph, distances are amounts of hops
+*/
+_GRAPH_TEMPLATE_DECLARE_UNWEIGHTED__(graph_unweighted, uint32_t)
+
+/**
+ * \brief Graph with 16-bit unsigned weights and 64-bit distances
+*/
+_GRAPH_TEMPLATE_DECLARE_WEIGHTED__(graph_u16, uint32_t, uint16_t, uint64_t)
+
+/**
+ * \brief Graph with 32-bit unsigned weights and 64-bit distances
+*/
+_GRAPH_TEMPLATE_DECLARE_WEIGHTED__(graph_u32, uint32_t, uint32_t, uint64_t)
+
+/**
+ * \brief Graph with 64-bit unsigned weights
+*/
+_GRAPH_TEMPLATE_DECLARE_WEIGHTED__(graph_u64, uint32_t, uint64_t, uint64_t)
+
+/**
+ * \brief Graph with single precision weights and double precision distances
+*/
+_GRAPH_TEMPLATE_DECLARE_WEIGHTED__(graph_f32, uint32_t, float, double)
+
+/**
+ * \brief Graph with double precision weights
+*/
+_GRAPH_TEMPLATE_DECLARE_WEIGHTED__(graph_f64, uint32_t, double, double)
+
+#endif // GRAPH_VARIANTS_H__
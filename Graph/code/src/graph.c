@@ -1,5 +1,11 @@
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "graph.h"
 
 #if defined(__linux__)
@@ -8,9 +14,216 @@
     #error "Unsupported operating system!"
 #endif 
 
+/**
+ * Amount of vertices taken by a thread from a shared work list at once
+*/
+#define _GRAPH_CHUNK_SIZE__ 64
+
+/**
+ * Max amount of buckets kept in the delta-stepping window
+*/
+#define _GRAPH_BUCKETS_MAX__ 4096
+
+/**
+ * Vertex is not placed in a heap
+*/
+#define _GRAPH_NO_POSITION__ SIZE_MAX
+
+/**
+ * Average degree starting from which graph is dense for the minimum spanning forest
+*/
+#define _GRAPH_MST_DENSITY__ 16
+
+/**
+ * Bits of a radix sort digit
+*/
+#define _GRAPH_RADIX_BITS__ 8
+
+/**
+ * Every such neighbour of a vertex in compressed adjacency is sampled for random access
+*/
+#define _GRAPH_SKIP_INTERVAL__ 64
+
+/**
+ * Max size of an encoded varint
+*/
+#define _GRAPH_VARINT_MAX__ 10
+
+/**
+ * Min amount of nonzero values of sparse matrix per thread of multiplication
+*/
+#define _GRAPH_SPARSE_THREAD_VALUES__ 65536
+
+/**
+ * Size of a memory-mapped page of disk-backed graph
+*/
+#define _GRAPH_DISK_PAGE__ (1 << 20)
+
+/**
+ * Min amount of memory-mapped pages of disk-backed graph
+*/
+#define _GRAPH_DISK_PAGES_MIN__ 4
+
+/**
+ * Amount of logged modifications starting the merge of disk-backed graph
+*/
+#define _GRAPH_DISK_DELTA_MAX__ 65536
+
+/**
+ * Max length of a file path of disk-backed graph
+*/
+#define _GRAPH_DISK_PATH__ (2 * _STRING__)
+
+/**
+ * Segments of disk-backed graph
+*/
+#define _GRAPH_DISK_OFFSETS__ 0
+#define _GRAPH_DISK_EDGES__ 1
+#define _GRAPH_DISK_NAMES__ 2
+#define _GRAPH_DISK_NAME_OFFSETS__ 3
+#define _GRAPH_DISK_NAME_ORDER__ 4
+#define _GRAPH_DISK_SEGMENTS__ 5
+
+/**
+ * Operations of the delta log of disk-backed graph
+*/
+#define _GRAPH_DISK_ADD_VERTEX__ 1
+#define _GRAPH_DISK_ADD_EDGE__ 2
+#define _GRAPH_DISK_DELETE_EDGE__ 3
+
+/**
+ * Amount of machine words in a bitset of multi-source breadth-first search
+*/
+#define _GRAPH_MS_BFS_WORDS__ (_GRAPH_MS_BFS_SOURCES__ / 64)
+
+/**
+ * Layered drawing sizes (in pixels) and amount of crossings reduction sweeps
+*/
+#define _GRAPH_SVG_MARGIN__ 20.0
+#define _GRAPH_SVG_LAYERS_GAP__ 80.0
+#define _GRAPH_SVG_VERTICES_GAP__ 20.0
+#define _GRAPH_SVG_VERTEX_HEIGHT__ 30.0
+#define _GRAPH_SVG_CHAR_WIDTH__ 7.5
+#define _GRAPH_SVG_DUMMY_WIDTH__ 10.0
+#define _GRAPH_SVG_SWEEPS__ 8
+
+/**
+ * Seed of the pseudo-random choice of sources sampled for betweenness centrality
+*/
+#define _GRAPH_BETWEENNESS_SEED__ 0x9E3779B97F4A7C15ULL
+
+/**
+ * Kinds of modifications logged in a batch
+*/
+#define _GRAPH_BATCH_ADD_VERTEX__ 0
+#define _GRAPH_BATCH_DELETE_VERTEX__ 1
+#define _GRAPH_BATCH_ADD_EDGE__ 2
+#define _GRAPH_BATCH_DELETE_EDGE__ 3
+
+/**
+ * Initial capacity of a batch log
+*/
+#define _GRAPH_BATCH_CAPACITY__ 64
+
+/**
+ * Directions of edges in compressed sparse rows adjacency
+*/
+#define _GRAPH_CSR_FORWARD__ 0
+#define _GRAPH_CSR_REVERSE__ 1
+#define _GRAPH_CSR_BOTH__ 2
+
+/**
+ * Edges as stored by their start vertices (undirected edges are not doubled)
+*/
+#define _GRAPH_CSR_STORED__ 3
+
+/**
+ * Last generation given to a graph (generations are unique across all graphs)
+*/
+static size_t __graph_generations = 0;
+
+static inline void __graph_touch(struct graph *graph)
+{
+    graph->generation = __atomic_add_fetch(&__graph_generations, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Undirected edges are keyed by the ordered pair of their vertices
+*/
+static inline void __graph_edge_key(const struct graph *graph, const char **start_vertex, const char **end_vertex)
+{
+    if (graph->mode == _GRAPH_UNDIRECTED__ && strcmp(*start_vertex, *end_vertex) > 0)
+    {
+        const char *tmp = *start_vertex;
+        *start_vertex = *end_vertex;
+        *end_vertex = tmp;
+    }
+}
+
+// batch log
+
+struct __graph_batch_operation
+{
+    int kind;
+    char *start_vertex;
+    char *end_vertex;
+    size_t length;
+};
+
+struct graph_batch
+{
+    struct __graph_batch_operation *operations;
+    size_t operations_amount;
+    size_t capacity;
+};
+
+static graph_error_t __graph_batch_log(struct graph *graph, int kind, const char *start_vertex, const char *end_vertex, size_t length)
+{
+    struct graph_batch *batch = graph->batch;
+
+    if (batch->operations_amount == batch->capacity)
+    {
+        size_t capacity = batch->capacity ? 2 * batch->capacity : _GRAPH_BATCH_CAPACITY__;
+
+        struct __graph_batch_operation *tmp = realloc(batch->operations, capacity * sizeof(struct __graph_batch_operation));
+        if (!tmp)
+            return _GRAPH_MEM__;
+
+        batch->operations = tmp;
+        batch->capacity = capacity;
+    }
+
+    if (end_vertex)
+        __graph_edge_key(graph, &start_vertex, &end_vertex);
+
+    struct __graph_batch_operation operation = { kind, strdup(start_vertex), end_vertex ? strdup(end_vertex) : NULL, length };
+
+    if (!operation.start_vertex || (end_vertex && !operation.end_vertex))
+    {
+        free(operation.start_vertex);
+        free(operation.end_vertex);
+        return _GRAPH_MEM__;
+    }
+
+    batch->operations[batch->operations_amount++] = operation;
+
+    return _GRAPH_OK__;
+}
+
 void graph_initialize(struct graph *graph)
 {   
+    graph_initialize_mode(graph, _GRAPH_DIRECTED__);
+}
+
+void graph_initialize_mode(struct graph *graph, int mode)
+{
+    if (!graph)
+        return;
+
     *graph = (struct graph) {0};
+    graph->mode = mode == _GRAPH_UNDIRECTED__ ? _GRAPH_UNDIRECTED__ : _GRAPH_DIRECTED__;
+
+    __graph_touch(graph);
 }
 
 int graph_is_empty(const struct graph *graph)
@@ -45,6 +258,8 @@ int graph_has_edge(const struct graph *graph, const char *start_vertex, const ch
         {
             if (graph_has_vertex(graph, start_vertex) && graph_has_vertex(graph, end_vertex))
             {
+                __graph_edge_key(graph, &start_vertex, &end_vertex);
+
                 for (size_t i = 0; i < graph->edges_amount; i++)
                 {
                     struct edge current_edge = graph->edges[i];
@@ -72,6 +287,9 @@ graph_error_t graph_add_vertex(struct graph *graph, const char *vertex)
             return _GRAPH_INCORRECT_ARG__;
     }
 
+    if (graph->batch)
+        return __graph_batch_log(graph, _GRAPH_BATCH_ADD_VERTEX__, vertex, NULL, 0);
+
     if (graph_has_vertex(graph, vertex))
         return _GRAPH_EXIST__;
 
@@ -93,6 +311,8 @@ graph_error_t graph_add_vertex(struct graph *graph, const char *vertex)
     else
         graph->vertices_amount++;
 
+    __graph_touch(graph);
+
     return _GRAPH_OK__;
 }
 
@@ -107,6 +327,9 @@ graph_error_t graph_delete_vertex(struct graph *graph, const char *vertex)
             return _GRAPH_INCORRECT_ARG__;
     }
 
+    if (graph->batch)
+        return __graph_batch_log(graph, _GRAPH_BATCH_DELETE_VERTEX__, vertex, NULL, 0);
+
     if (graph_is_empty(graph))
         return _GRAPH_EMPTY__;
 
@@ -139,6 +362,8 @@ graph_error_t graph_delete_vertex(struct graph *graph, const char *vertex)
     graph->vertices = (char **) realloc(graph->vertices, (graph->vertices_amount - 1) * sizeof(char *));
     graph->vertices_amount--;
 
+    __graph_touch(graph);
+
     return _GRAPH_OK__;
 }
 
@@ -160,9 +385,14 @@ graph_error_t graph_add_edge(struct graph *graph, const char *start_vertex, cons
             return _GRAPH_INCORRECT_ARG__;
     }
 
+    if (graph->batch)
+        return __graph_batch_log(graph, _GRAPH_BATCH_ADD_EDGE__, start_vertex, end_vertex, edge_length);
+
     if (graph_has_edge(graph, start_vertex, end_vertex))
         return _GRAPH_EXIST__;
 
+    __graph_edge_key(graph, &start_vertex, &end_vertex);
+
     struct edge edge_to_add = {0};
 
     strcpy(edge_to_add.start_vertex, start_vertex);
@@ -179,6 +409,8 @@ graph_error_t graph_add_edge(struct graph *graph, const char *start_vertex, cons
         graph->edges_amount++;
     }
 
+    __graph_touch(graph);
+
     if (!graph_has_vertex(graph, start_vertex))
         graph_add_vertex(graph, start_vertex);    
 
@@ -206,9 +438,14 @@ graph_error_t graph_delete_edge(struct graph *graph, const char *start_vertex, c
             return _GRAPH_INCORRECT_ARG__;
     }
 
+    if (graph->batch)
+        return __graph_batch_log(graph, _GRAPH_BATCH_DELETE_EDGE__, start_vertex, end_vertex, 0);
+
     if (!graph_has_edge(graph, start_vertex, end_vertex))
         return _GRAPH_NOT_FOUND__;
 
+    __graph_edge_key(graph, &start_vertex, &end_vertex);
+
     for (size_t i = 0; i < graph->edges_amount; i++)
     {
         struct edge current_edge = graph->edges[i];
@@ -225,6 +462,8 @@ graph_error_t graph_delete_edge(struct graph *graph, const char *start_vertex, c
     graph->edges = (struct edge *) realloc(graph->edges, (graph->edges_amount - 1) * sizeof(struct edge));
     graph->edges_amount--;
 
+    __graph_touch(graph);
+
     return _GRAPH_OK__;
 }
 
@@ -280,7 +519,9 @@ graph_error_t graph_to_dot(const struct graph *graph, const char *folder, const
     
     // file processing
 
-    fprintf(dot_file, "digraph picture {\n");
+    int undirected = graph->mode == _GRAPH_UNDIRECTED__;
+
+    fprintf(dot_file, "%s picture {\n", undirected ? "graph" : "digraph");
 
     // edges to dot
 
@@ -288,7 +529,8 @@ graph_error_t graph_to_dot(const struct graph *graph, const char *folder, const
     {
         struct edge current_edge = graph->edges[i];
 
-        fprintf(dot_file, "\"%s\" -> \"%s\" [label=  %zu];\n", current_edge.start_vertex, current_edge.end_vertex, current_edge.length);
+        fprintf(dot_file, "\"%s\" %s \"%s\" [label=  %zu];\n", current_edge.start_vertex, undirected ? "--" : "->", \
+            current_edge.end_vertex, current_edge.length);
     }
 
     // vertices (not in edges) to dot
@@ -373,14 +615,23 @@ graph_error_t graph_adjacency_list_fill(const struct graph *graph, const char *v
     for (size_t i = 0, k = 0; i < graph->edges_amount; i++)
     {
         struct edge current_edge = graph->edges[i];
-        
+
+        // undirected edges lead to the other vertex from both ends
+
+        const char *adjacent_vertex = NULL;
+
         if (!strcmp(vertex, current_edge.start_vertex))
+            adjacent_vertex = current_edge.end_vertex;
+        else if (graph->mode == _GRAPH_UNDIRECTED__ && !strcmp(vertex, current_edge.end_vertex))
+            adjacent_vertex = current_edge.start_vertex;
+        
+        if (adjacent_vertex)
         {
             int end_vertex_finded = 0;
 
             for (size_t j = 0; j < graph->vertices_amount && !end_vertex_finded; j++)
             {
-                if (!strcmp(graph->vertices[j], current_edge.end_vertex))
+                if (!strcmp(graph->vertices[j], adjacent_vertex))
                 {
                     adjacency_list[k++] = j;
                     end_vertex_finded = 1; 
@@ -436,12 +687,17 @@ struct matrix *graph_adjacency_matrix_create(const struct graph *graph)
             {
                 int edge_is_finded = 0;
 
+                const char *start_vertex = graph->vertices[i];
+                const char *end_vertex = graph->vertices[j];
+
+                __graph_edge_key(graph, &start_vertex, &end_vertex);
+
                 for (size_t k = 0; k < graph->edges_amount && !edge_is_finded; k++)
                 {
                     struct edge current_edge = graph->edges[k];
 
-                    if (!strcmp(current_edge.start_vertex, graph->vertices[i]) \
-                        && !strcmp(current_edge.end_vertex, graph->vertices[j]))
+                    if (!strcmp(current_edge.start_vertex, start_vertex) \
+                        && !strcmp(current_edge.end_vertex, end_vertex))
                     {
                         matrix->values[i][j] = current_edge.length;
                         edge_is_finded = 1;    
@@ -595,7 +851,7 @@ static inline void __graph_dfs_step(struct graph *graph, void (*vertex_processin
 
     size_t adjacent_vertices = graph_adjacency_list_size(graph, graph->vertices[vertex_index]);
 
-    int adjacent_vertices_indexes[adjacent_vertices];
+    int adjacent_vertices_indexes[adjacent_vertices + 1];
 
     graph_adjacency_list_fill(graph, graph->vertices[vertex_index], adjacent_vertices_indexes);
 
@@ -608,17 +864,37 @@ static inline void __graph_dfs_step(struct graph *graph, void (*vertex_processin
 
     for (size_t i = 0; i < graph->edges_amount; i++)
     {
+        int renamed = 0;
+
         if (!strcmp(vertex_copy, graph->edges[i].start_vertex))
+        {
             strcpy(graph->edges[i].start_vertex, graph->vertices[vertex_index]);
+            renamed = 1;
+        }
         
         if (!strcmp(vertex_copy, graph->edges[i].end_vertex))
+        {
             strcpy(graph->edges[i].end_vertex, graph->vertices[vertex_index]);
+            renamed = 1;
+        }
+
+        // renamed undirected edge is put back into the key order
+
+        if (renamed && graph->mode == _GRAPH_UNDIRECTED__ \
+            && strcmp(graph->edges[i].start_vertex, graph->edges[i].end_vertex) > 0)
+        {
+            char tmp[_STRING__ + 1];
+
+            strcpy(tmp, graph->edges[i].start_vertex);
+            strcpy(graph->edges[i].start_vertex, graph->edges[i].end_vertex);
+            strcpy(graph->edges[i].end_vertex, tmp);
+        }
     }
     
     // processing vertices from the adjacency list
 
-    for (size_t i = 0, index = adjacent_vertices_indexes[i]; i < adjacent_vertices; i++, index = adjacent_vertices_indexes[i])
-        __graph_dfs_step(graph, vertex_processing, index, new); 
+    for (size_t i = 0; i < adjacent_vertices; i++)
+        __graph_dfs_step(graph, vertex_processing, adjacent_vertices_indexes[i], new); 
 }
 
 void graph_dfs(struct graph *graph, void (*vertex_processing)(char *vertex_name))
@@ -635,6 +911,10 @@ void graph_dfs(struct graph *graph, void (*vertex_processing)(char *vertex_name)
 
     for (size_t i = 0; i < vertices_amount; i++)
         __graph_dfs_step(graph, vertex_processing, i, new);
+
+    // vertex processing function can rename vertices
+
+    __graph_touch(graph);
 }
 
 struct matrix *graph_floyd_warshall(const struct graph *graph)
@@ -688,9 +968,6604 @@ void graph_adjacency_matrix_free(struct matrix *adjacency_matrix)
 
 void graph_free(struct graph *graph)
 {
+    graph_batch_abort(graph);
+
     for (size_t i = 0; i < graph->vertices_amount; i++)
         free(graph->vertices[i]);
 
     free(graph->vertices);
     free(graph->edges);
 }
+
+// vertex names index
+
+struct __graph_name
+{
+    const char *name;
+    size_t index;
+};
+
+static int __graph_name_compare(const void *first, const void *second)
+{
+    const struct __graph_name *first_name = first;
+    const struct __graph_name *second_name = second;
+
+    return strcmp(first_name->name, second_name->name);
+}
+
+static struct __graph_name *__graph_names_create(const struct graph *graph)
+{
+    struct __graph_name *names = malloc((graph->vertices_amount + 1) * sizeof(struct __graph_name));
+    if (!names)
+        return NULL;
+
+    for (size_t i = 0; i < graph->vertices_amount; i++)
+        names[i] = (struct __graph_name) { graph->vertices[i], i };
+
+    qsort(names, graph->vertices_amount, sizeof(struct __graph_name), __graph_name_compare);
+
+    return names;
+}
+
+static size_t __graph_names_find(const struct __graph_name *names, size_t names_amount, const char *vertex)
+{
+    struct __graph_name key = { vertex, 0 };
+
+    const struct __graph_name *found = bsearch(&key, names, names_amount, sizeof(struct __graph_name), __graph_name_compare);
+
+    return found ? found->index : names_amount;
+}
+
+// compressed sparse rows adjacency
+
+struct __graph_csr
+{
+    size_t vertices_amount;
+    size_t edges_amount;
+    size_t *offsets;
+    size_t *targets;
+    size_t *lengths;
+    size_t *edges;
+};
+
+static void __graph_csr_free(struct __graph_csr *csr)
+{
+    free(csr->offsets);
+    free(csr->targets);
+    free(csr->lengths);
+    free(csr->edges);
+
+    *csr = (struct __graph_csr) {0};
+}
+
+static void __graph_edges_resolve(const struct graph *graph, const struct __graph_name *names, size_t *starts, size_t *ends)
+{
+    for (size_t i = 0; i < graph->edges_amount; i++)
+    {
+        starts[i] = __graph_names_find(names, graph->vertices_amount, graph->edges[i].start_vertex);
+        ends[i] = __graph_names_find(names, graph->vertices_amount, graph->edges[i].end_vertex);
+
+        // edges with unknown endpoints are marked by both endpoints out of range
+
+        if (starts[i] == graph->vertices_amount || ends[i] == graph->vertices_amount)
+            starts[i] = ends[i] = graph->vertices_amount;
+    }
+}
+
+graph_error_t graph_edges_indexes(const struct graph *graph, size_t *starts, size_t *ends)
+{
+    if (!graph || ((!starts || !ends) && graph->edges_amount))
+        return _GRAPH_INCORRECT_ARG__;
+
+    struct __graph_name *names = __graph_names_create(graph);
+    if (!names)
+        return _GRAPH_MEM__;
+
+    __graph_edges_resolve(graph, names, starts, ends);
+
+    free(names);
+
+    return _GRAPH_OK__;
+}
+
+// batched modifications
+
+/**
+ * Modification of a single vertex or edge, ordered by its position in the log
+*/
+struct __graph_batch_event
+{
+    const char *start_vertex;
+    const char *end_vertex;
+    size_t order;
+    int kind;
+    size_t length;
+};
+
+/**
+ * Outcome of the logged modifications of a vertex
+*/
+struct __graph_batch_vertex
+{
+    const char *name;
+    size_t index;
+    size_t deleted;
+    size_t added;
+};
+
+static int __graph_batch_event_compare(const void *first, const void *second)
+{
+    const struct __graph_batch_event *first_event = first;
+    const struct __graph_batch_event *second_event = second;
+
+    int cmp = strcmp(first_event->start_vertex, second_event->start_vertex);
+
+    if (!cmp && first_event->end_vertex)
+        cmp = strcmp(first_event->end_vertex, second_event->end_vertex);
+
+    if (!cmp)
+        cmp = (first_event->order > second_event->order) - (first_event->order < second_event->order);
+
+    return cmp;
+}
+
+static int __graph_batch_edge_compare(const void *first, const void *second)
+{
+    const struct edge *first_edge = *(const struct edge *const *) first;
+    const struct edge *second_edge = *(const struct edge *const *) second;
+
+    int cmp = strcmp(first_edge->start_vertex, second_edge->start_vertex);
+
+    return cmp ? cmp : strcmp(first_edge->end_vertex, second_edge->end_vertex);
+}
+
+static int __graph_batch_vertex_compare(const void *first, const void *second)
+{
+    return strcmp(((const struct __graph_batch_vertex *) first)->name, ((const struct __graph_batch_vertex *) second)->name);
+}
+
+static int __graph_batch_vertex_order_compare(const void *first, const void *second)
+{
+    size_t first_order = ((const struct __graph_batch_vertex *) first)->added;
+    size_t second_order = ((const struct __graph_batch_vertex *) second)->added;
+
+    return (first_order > second_order) - (first_order < second_order);
+}
+
+static int __graph_batch_event_order_compare(const void *first, const void *second)
+{
+    size_t first_order = (*(const struct __graph_batch_event *const *) first)->order;
+    size_t second_order = (*(const struct __graph_batch_event *const *) second)->order;
+
+    return (first_order > second_order) - (first_order < second_order);
+}
+
+static void __graph_batch_events_create(const struct graph_batch *batch, struct __graph_batch_event *vertex_events, \
+    size_t *vertex_events_amount, struct __graph_batch_event *edge_events, size_t *edge_events_amount)
+{
+    *vertex_events_amount = 0;
+    *edge_events_amount = 0;
+
+    // vertices events are ordered inside an operation as they are added by `graph_add_edge`
+
+    for (size_t i = 0; i < batch->operations_amount; i++)
+    {
+        const struct __graph_batch_operation *operation = batch->operations + i;
+
+        switch (operation->kind)
+        {
+            case _GRAPH_BATCH_ADD_VERTEX__:
+            case _GRAPH_BATCH_DELETE_VERTEX__:
+                vertex_events[(*vertex_events_amount)++] = (struct __graph_batch_event) \
+                    { operation->start_vertex, NULL, 3 * i, operation->kind, 0 };
+                break;
+
+            case _GRAPH_BATCH_ADD_EDGE__:
+                vertex_events[(*vertex_events_amount)++] = (struct __graph_batch_event) \
+                    { operation->start_vertex, NULL, 3 * i + 1, _GRAPH_BATCH_ADD_VERTEX__, 0 };
+                vertex_events[(*vertex_events_amount)++] = (struct __graph_batch_event) \
+                    { operation->end_vertex, NULL, 3 * i + 2, _GRAPH_BATCH_ADD_VERTEX__, 0 };
+                // fall through
+
+            default:
+                edge_events[(*edge_events_amount)++] = (struct __graph_batch_event) \
+                    { operation->start_vertex, operation->end_vertex, i, operation->kind, operation->length };
+        }
+    }
+
+    qsort(vertex_events, *vertex_events_amount, sizeof(struct __graph_batch_event), __graph_batch_event_compare);
+    qsort(edge_events, *edge_events_amount, sizeof(struct __graph_batch_event), __graph_batch_event_compare);
+}
+
+static size_t __graph_batch_vertices_merge(const struct graph *graph, const struct __graph_name *names, \
+    const struct __graph_batch_event *events, size_t events_amount, struct __graph_batch_vertex *vertices, char *moved)
+{
+    size_t vertices_amount = 0;
+    size_t name = 0;
+
+    for (size_t i = 0; i < events_amount;)
+    {
+        const char *vertex = events[i].start_vertex;
+
+        while (name < graph->vertices_amount && strcmp(names[name].name, vertex) < 0)
+            name++;
+
+        struct __graph_batch_vertex current = { vertex, _GRAPH_NO_POSITION__, 0, _GRAPH_NO_POSITION__ };
+
+        if (name < graph->vertices_amount && !strcmp(names[name].name, vertex))
+            current.index = names[name].index;
+
+        // replaying the modifications of the vertex in the logged order
+
+        int exists = current.index != _GRAPH_NO_POSITION__;
+
+        for (; i < events_amount && !strcmp(events[i].start_vertex, vertex); i++)
+        {
+            if (events[i].kind == _GRAPH_BATCH_ADD_VERTEX__ && !exists)
+            {
+                exists = 1;
+                current.added = events[i].order;
+            }
+            else if (events[i].kind == _GRAPH_BATCH_DELETE_VERTEX__)
+            {
+                exists = 0;
+                current.added = _GRAPH_NO_POSITION__;
+                current.deleted = events[i].order / 3 + 1;
+            }
+        }
+
+        // a vertex deleted or added again leaves its place in the vertices array
+
+        if (current.index != _GRAPH_NO_POSITION__ && (!exists || current.added != _GRAPH_NO_POSITION__))
+            moved[current.index] = 1;
+
+        vertices[vertices_amount++] = current;
+    }
+
+    return vertices_amount;
+}
+
+static size_t __graph_batch_vertex_deleted(const struct __graph_batch_vertex *vertices, size_t vertices_amount, const char *vertex)
+{
+    struct __graph_batch_vertex key = { vertex, 0, 0, 0 };
+
+    const struct __graph_batch_vertex *found = bsearch(&key, vertices, vertices_amount, sizeof(struct __graph_batch_vertex), \
+        __graph_batch_vertex_compare);
+
+    return found ? found->deleted : 0;
+}
+
+static size_t __graph_batch_edges_merge(const struct graph *graph, const struct edge **edges, \
+    const struct __graph_batch_event *events, size_t events_amount, const struct __graph_batch_vertex *vertices, \
+    size_t vertices_amount, char *removed, const struct __graph_batch_event **added)
+{
+    size_t added_amount = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < graph->edges_amount || j < events_amount)
+    {
+        int cmp = 0;
+
+        if (i == graph->edges_amount)
+            cmp = 1;
+        else if (j == events_amount)
+            cmp = -1;
+        else
+        {
+            cmp = strcmp(edges[i]->start_vertex, events[j].start_vertex);
+            if (!cmp)
+                cmp = strcmp(edges[i]->end_vertex, events[j].end_vertex);
+        }
+
+        const struct edge *original = cmp <= 0 ? edges[i++] : NULL;
+
+        const char *start_vertex = original ? original->start_vertex : events[j].start_vertex;
+        const char *end_vertex = original ? original->end_vertex : events[j].end_vertex;
+
+        size_t first = j;
+
+        while (j < events_amount && !strcmp(events[j].start_vertex, start_vertex) && !strcmp(events[j].end_vertex, end_vertex))
+            j++;
+
+        // the edge disappears with the last deletion of it or of its vertices
+
+        size_t deleted = __graph_batch_vertex_deleted(vertices, vertices_amount, start_vertex);
+        size_t end_deleted = __graph_batch_vertex_deleted(vertices, vertices_amount, end_vertex);
+
+        if (end_deleted > deleted)
+            deleted = end_deleted;
+
+        for (size_t k = first; k < j; k++)
+            if (events[k].kind == _GRAPH_BATCH_DELETE_EDGE__ && events[k].order + 1 > deleted)
+                deleted = events[k].order + 1;
+
+        if (original && !deleted)
+            continue;
+
+        if (original)
+            removed[original - graph->edges] = 1;
+
+        // the first addition after the disappearance appends the edge
+
+        for (size_t k = first; k < j; k++)
+        {
+            if (events[k].kind == _GRAPH_BATCH_ADD_EDGE__ && events[k].order >= deleted)
+            {
+                added[added_amount++] = events + k;
+                break;
+            }
+        }
+    }
+
+    return added_amount;
+}
+
+graph_error_t graph_batch_begin(struct graph *graph)
+{
+    if (!graph)
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (graph->batch)
+        return _GRAPH_EXIST__;
+
+    graph->batch = calloc(1, sizeof(struct graph_batch));
+
+    return graph->batch ? _GRAPH_OK__ : _GRAPH_MEM__;
+}
+
+graph_error_t graph_batch_commit(struct graph *graph)
+{
+    if (!graph)
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (!graph->batch)
+        return _GRAPH_NOT_FOUND__;
+
+    const struct graph_batch *batch = graph->batch;
+
+    if (!batch->operations_amount)
+    {
+        graph_batch_abort(graph);
+        return _GRAPH_OK__;
+    }
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    size_t operations_amount = batch->operations_amount;
+
+    // every operation gives at most two vertices events and one edge event
+
+    struct __graph_batch_event *vertex_events = malloc(2 * operations_amount * sizeof(struct __graph_batch_event));
+    struct __graph_batch_event *edge_events = malloc(operations_amount * sizeof(struct __graph_batch_event));
+    struct __graph_batch_vertex *vertices = malloc(2 * operations_amount * sizeof(struct __graph_batch_vertex));
+    const struct __graph_batch_event **added_edges = malloc(operations_amount * sizeof(struct __graph_batch_event *));
+    const struct edge **edges = malloc((graph->edges_amount + 1) * sizeof(struct edge *));
+    char *moved = calloc(graph->vertices_amount + 1, sizeof(char));
+    char *removed = calloc(graph->edges_amount + 1, sizeof(char));
+    struct __graph_name *names = __graph_names_create(graph);
+
+    if (!vertex_events || !edge_events || !vertices || !added_edges || !edges || !moved || !removed || !names)
+        rc = _GRAPH_MEM__;
+
+    size_t vertices_amount = 0;
+    size_t added_vertices_amount = 0;
+    size_t added_edges_amount = 0;
+    size_t new_vertices_amount = graph->vertices_amount;
+    size_t new_edges_amount = graph->edges_amount;
+
+    // resolving the outcome of the log by merging sorted modifications with sorted vertices and edges
+
+    if (rc == _GRAPH_OK__)
+    {
+        size_t vertex_events_amount = 0;
+        size_t edge_events_amount = 0;
+
+        __graph_batch_events_create(batch, vertex_events, &vertex_events_amount, edge_events, &edge_events_amount);
+
+        vertices_amount = __graph_batch_vertices_merge(graph, names, vertex_events, vertex_events_amount, vertices, moved);
+
+        for (size_t i = 0; i < graph->edges_amount; i++)
+            edges[i] = graph->edges + i;
+
+        qsort(edges, graph->edges_amount, sizeof(struct edge *), __graph_batch_edge_compare);
+
+        added_edges_amount = __graph_batch_edges_merge(graph, edges, edge_events, edge_events_amount, vertices, vertices_amount, \
+            removed, added_edges);
+
+        // appended vertices and edges keep the order of the log
+
+        qsort(vertices, vertices_amount, sizeof(struct __graph_batch_vertex), __graph_batch_vertex_order_compare);
+
+        while (added_vertices_amount < vertices_amount && vertices[added_vertices_amount].added != _GRAPH_NO_POSITION__)
+            added_vertices_amount++;
+
+        qsort(added_edges, added_edges_amount, sizeof(struct __graph_batch_event *), __graph_batch_event_order_compare);
+
+        for (size_t i = 0; i < graph->vertices_amount; i++)
+            new_vertices_amount -= moved[i];
+
+        for (size_t i = 0; i < graph->edges_amount; i++)
+            new_edges_amount -= removed[i];
+
+        new_vertices_amount += added_vertices_amount;
+        new_edges_amount += added_edges_amount;
+    }
+
+    // building new arrays before the graph is changed, so nothing is applied on memory shortage
+
+    char **new_vertices = NULL;
+    struct edge *new_edges = NULL;
+
+    if (rc == _GRAPH_OK__)
+    {
+        new_vertices = malloc((new_vertices_amount + 1) * sizeof(char *));
+        new_edges = malloc((new_edges_amount + 1) * sizeof(struct edge));
+
+        if (!new_vertices || !new_edges)
+            rc = _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        size_t position = 0;
+
+        for (size_t i = 0; i < graph->vertices_amount; i++)
+            if (!moved[i])
+                new_vertices[position++] = graph->vertices[i];
+
+        for (size_t i = 0; i < added_vertices_amount; i++)
+        {
+            new_vertices[position + i] = strdup(vertices[i].name);
+
+            if (!new_vertices[position + i])
+            {
+                while (i--)
+                    free(new_vertices[position + i]);
+
+                rc = _GRAPH_MEM__;
+                break;
+            }
+        }
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        size_t position = 0;
+
+        for (size_t i = 0; i < graph->edges_amount; i++)
+            if (!removed[i])
+                new_edges[position++] = graph->edges[i];
+
+        for (size_t i = 0; i < added_edges_amount; i++, position++)
+        {
+            new_edges[position] = (struct edge) {0};
+
+            strcpy(new_edges[position].start_vertex, added_edges[i]->start_vertex);
+            strcpy(new_edges[position].end_vertex, added_edges[i]->end_vertex);
+            new_edges[position].length = added_edges[i]->length;
+        }
+
+        for (size_t i = 0; i < graph->vertices_amount; i++)
+            if (moved[i])
+                free(graph->vertices[i]);
+
+        free(graph->vertices);
+        free(graph->edges);
+
+        graph->vertices = new_vertices;
+        graph->vertices_amount = new_vertices_amount;
+        graph->edges = new_edges;
+        graph->edges_amount = new_edges_amount;
+
+        __graph_touch(graph);
+    }
+    else
+    {
+        free(new_vertices);
+        free(new_edges);
+    }
+
+    free(vertex_events);
+    free(edge_events);
+    free(vertices);
+    free(added_edges);
+    free(edges);
+    free(moved);
+    free(removed);
+    free(names);
+
+    if (rc == _GRAPH_OK__)
+        graph_batch_abort(graph);
+
+    return rc;
+}
+
+void graph_batch_abort(struct graph *graph)
+{
+    if (!graph || !graph->batch)
+        return;
+
+    for (size_t i = 0; i < graph->batch->operations_amount; i++)
+    {
+        free(graph->batch->operations[i].start_vertex);
+        free(graph->batch->operations[i].end_vertex);
+    }
+
+    free(graph->batch->operations);
+    free(graph->batch);
+
+    graph->batch = NULL;
+}
+
+/**
+ * Compressed adjacency of edges with already resolved vertices
+*/
+static graph_error_t __graph_csr_resolved_create(const struct graph *graph, const size_t *starts, const size_t *ends, \
+    int direction, struct __graph_csr *csr)
+{
+    size_t vertices_amount = graph->vertices_amount;
+    size_t edges_amount = graph->edges_amount;
+
+    // undirected edges are traversed from both vertices, loops once
+
+    int undirected = graph->mode == _GRAPH_UNDIRECTED__ && direction != _GRAPH_CSR_STORED__;
+    int forward = direction != _GRAPH_CSR_REVERSE__ || undirected;
+    int reverse = direction == _GRAPH_CSR_REVERSE__ || direction == _GRAPH_CSR_BOTH__ || undirected;
+
+    size_t entries_amount = forward && reverse ? 2 * edges_amount : edges_amount;
+
+    *csr = (struct __graph_csr) {0};
+    csr->vertices_amount = vertices_amount;
+
+    csr->offsets = calloc(vertices_amount + 1, sizeof(size_t));
+    csr->targets = malloc((entries_amount + 1) * sizeof(size_t));
+    csr->lengths = malloc((entries_amount + 1) * sizeof(size_t));
+    csr->edges = malloc((entries_amount + 1) * sizeof(size_t));
+
+    if (!csr->offsets || !csr->targets || !csr->lengths || !csr->edges)
+    {
+        __graph_csr_free(csr);
+
+        return _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < edges_amount; i++)
+    {
+        if (starts[i] == vertices_amount)
+            continue;
+
+        if (forward)
+            csr->offsets[starts[i] + 1]++;
+
+        if (reverse && !(undirected && starts[i] == ends[i]))
+            csr->offsets[ends[i] + 1]++;
+    }
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        csr->offsets[i + 1] += csr->offsets[i];
+
+    // counting sort of edges by source vertex
+
+    for (size_t i = 0; i < edges_amount; i++)
+    {
+        if (starts[i] == vertices_amount)
+            continue;
+
+        if (forward)
+        {
+            size_t position = csr->offsets[starts[i]]++;
+
+            csr->targets[position] = ends[i];
+            csr->lengths[position] = graph->edges[i].length;
+            csr->edges[position] = i;
+        }
+
+        if (reverse && !(undirected && starts[i] == ends[i]))
+        {
+            size_t position = csr->offsets[ends[i]]++;
+
+            csr->targets[position] = starts[i];
+            csr->lengths[position] = graph->edges[i].length;
+            csr->edges[position] = i;
+        }
+    }
+
+    for (size_t i = vertices_amount; i > 0; i--)
+        csr->offsets[i] = csr->offsets[i - 1];
+    csr->offsets[0] = 0;
+
+    csr->edges_amount = csr->offsets[vertices_amount];
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_csr_create(const struct graph *graph, const struct __graph_name *names, int direction, struct __graph_csr *csr)
+{
+    size_t *starts = malloc((graph->edges_amount + 1) * sizeof(size_t));
+    size_t *ends = malloc((graph->edges_amount + 1) * sizeof(size_t));
+
+    graph_error_t rc = starts && ends ? _GRAPH_OK__ : _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+    {
+        __graph_edges_resolve(graph, names, starts, ends);
+        rc = __graph_csr_resolved_create(graph, starts, ends, direction, csr);
+    }
+
+    free(ends);
+    free(starts);
+
+    return rc;
+}
+
+static graph_error_t __graph_csr_from_source(const struct graph *graph, const char *source, int direction, struct __graph_csr *csr, size_t *source_index)
+{
+    if (!graph || !source || !strlen(source))
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    struct __graph_name *names = __graph_names_create(graph);
+    if (!names)
+        return _GRAPH_MEM__;
+
+    *source_index = __graph_names_find(names, graph->vertices_amount, source);
+
+    graph_error_t rc = _GRAPH_NOT_FOUND__;
+
+    if (*source_index != graph->vertices_amount)
+        rc = __graph_csr_create(graph, names, direction, csr);
+
+    free(names);
+
+    return rc;
+}
+
+// indexed binary min-heap of vertices
+
+struct __graph_heap
+{
+    size_t *vertices;
+    size_t *positions;
+    size_t *keys;
+    size_t size;
+};
+
+static void __graph_heap_free(struct __graph_heap *heap)
+{
+    free(heap->vertices);
+    free(heap->positions);
+    free(heap->keys);
+
+    *heap = (struct __graph_heap) {0};
+}
+
+static graph_error_t __graph_heap_create(struct __graph_heap *heap, size_t vertices_amount)
+{
+    *heap = (struct __graph_heap) {0};
+
+    heap->vertices = malloc((vertices_amount + 1) * sizeof(size_t));
+    heap->positions = malloc((vertices_amount + 1) * sizeof(size_t));
+    heap->keys = malloc((vertices_amount + 1) * sizeof(size_t));
+
+    if (!heap->vertices || !heap->positions || !heap->keys)
+    {
+        __graph_heap_free(heap);
+        return _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        heap->positions[i] = _GRAPH_NO_POSITION__;
+
+    return _GRAPH_OK__;
+}
+
+static inline void __graph_heap_place(struct __graph_heap *heap, size_t position, size_t vertex)
+{
+    heap->vertices[position] = vertex;
+    heap->positions[vertex] = position;
+}
+
+static void __graph_heap_sift_up(struct __graph_heap *heap, size_t position)
+{
+    size_t vertex = heap->vertices[position];
+
+    while (position > 0)
+    {
+        size_t parent = (position - 1) / 2;
+
+        if (heap->keys[heap->vertices[parent]] <= heap->keys[vertex])
+            break;
+
+        __graph_heap_place(heap, position, heap->vertices[parent]);
+        position = parent;
+    }
+
+    __graph_heap_place(heap, position, vertex);
+}
+
+static void __graph_heap_sift_down(struct __graph_heap *heap, size_t position)
+{
+    size_t vertex = heap->vertices[position];
+
+    for (;;)
+    {
+        size_t child = 2 * position + 1;
+
+        if (child >= heap->size)
+            break;
+
+        if (child + 1 < heap->size && heap->keys[heap->vertices[child + 1]] < heap->keys[heap->vertices[child]])
+            child++;
+
+        if (heap->keys[vertex] <= heap->keys[heap->vertices[child]])
+            break;
+
+        __graph_heap_place(heap, position, heap->vertices[child]);
+        position = child;
+    }
+
+    __graph_heap_place(heap, position, vertex);
+}
+
+static void __graph_heap_push(struct __graph_heap *heap, size_t vertex, size_t key)
+{
+    if (heap->positions[vertex] == _GRAPH_NO_POSITION__)
+    {
+        heap->keys[vertex] = key;
+        __graph_heap_place(heap, heap->size++, vertex);
+        __graph_heap_sift_up(heap, heap->size - 1);
+    }
+    else if (key < heap->keys[vertex])
+    {
+        heap->keys[vertex] = key;
+        __graph_heap_sift_up(heap, heap->positions[vertex]);
+    }
+}
+
+static size_t __graph_heap_pop(struct __graph_heap *heap)
+{
+    size_t top = heap->vertices[0];
+
+    heap->positions[top] = _GRAPH_NO_POSITION__;
+    heap->size--;
+
+    if (heap->size)
+    {
+        __graph_heap_place(heap, 0, heap->vertices[heap->size]);
+        __graph_heap_sift_down(heap, 0);
+    }
+
+    return top;
+}
+
+// dynamic array of vertices
+
+struct __graph_buffer
+{
+    size_t *values;
+    size_t size;
+    size_t capacity;
+};
+
+static graph_error_t __graph_buffer_push(struct __graph_buffer *buffer, size_t value)
+{
+    if (buffer->size == buffer->capacity)
+    {
+        size_t capacity = buffer->capacity ? 2 * buffer->capacity : 16;
+
+        size_t *tmp = realloc(buffer->values, capacity * sizeof(size_t));
+        if (!tmp)
+            return _GRAPH_MEM__;
+
+        buffer->values = tmp;
+        buffer->capacity = capacity;
+    }
+
+    buffer->values[buffer->size++] = value;
+
+    return _GRAPH_OK__;
+}
+
+// thread pool running one task on all threads at once
+
+struct __graph_pool_worker
+{
+    struct __graph_pool *pool;
+    size_t index;
+};
+
+struct __graph_pool
+{
+    pthread_t *threads;
+    struct __graph_pool_worker *workers;
+    size_t threads_amount;
+    pthread_mutex_t mutex;
+    pthread_cond_t started;
+    pthread_cond_t finished;
+    size_t generation;
+    size_t running;
+    int stop;
+    void (*task)(void *context, size_t thread_index);
+    void *context;
+};
+
+static size_t __graph_threads_amount(size_t threads_amount)
+{
+    if (threads_amount)
+        return threads_amount;
+
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return processors > 0 ? (size_t) processors : 1;
+}
+
+static void *__graph_pool_loop(void *argument)
+{
+    struct __graph_pool_worker *worker = argument;
+    struct __graph_pool *pool = worker->pool;
+
+    size_t generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    for (;;)
+    {
+        while (pool->generation == generation && !pool->stop)
+            pthread_cond_wait(&pool->started, &pool->mutex);
+
+        if (pool->stop)
+            break;
+
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        pool->task(pool->context, worker->index);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->running == 0)
+            pthread_cond_signal(&pool->finished);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+static graph_error_t __graph_pool_create(struct __graph_pool *pool, size_t threads_amount)
+{
+    *pool = (struct __graph_pool) {0};
+    pool->threads_amount = 1;
+
+    if (threads_amount <= 1)
+        return _GRAPH_OK__;
+
+    pool->threads = malloc((threads_amount - 1) * sizeof(pthread_t));
+    pool->workers = malloc((threads_amount - 1) * sizeof(struct __graph_pool_worker));
+
+    if (!pool->threads || !pool->workers)
+    {
+        free(pool->threads);
+        free(pool->workers);
+
+        return _GRAPH_MEM__;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->started, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+
+    // the calling thread is the worker with zero index, failed threads reduce the pool
+
+    for (size_t i = 0; i < threads_amount - 1; i++)
+    {
+        pool->workers[i] = (struct __graph_pool_worker) { pool, i + 1 };
+
+        if (pthread_create(&pool->threads[i], NULL, __graph_pool_loop, &pool->workers[i]))
+            break;
+
+        pool->threads_amount++;
+    }
+
+    return _GRAPH_OK__;
+}
+
+static void __graph_pool_run(struct __graph_pool *pool, void (*task)(void *context, size_t thread_index), void *context)
+{
+    if (pool->threads_amount == 1)
+    {
+        task(context, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->task = task;
+    pool->context = context;
+    pool->running = pool->threads_amount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->started);
+    pthread_mutex_unlock(&pool->mutex);
+
+    task(context, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->running)
+        pthread_cond_wait(&pool->finished, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void __graph_pool_free(struct __graph_pool *pool)
+{
+    if (pool->threads)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        pool->stop = 1;
+        pthread_cond_broadcast(&pool->started);
+        pthread_mutex_unlock(&pool->mutex);
+
+        for (size_t i = 0; i < pool->threads_amount - 1; i++)
+            pthread_join(pool->threads[i], NULL);
+
+        pthread_mutex_destroy(&pool->mutex);
+        pthread_cond_destroy(&pool->started);
+        pthread_cond_destroy(&pool->finished);
+    }
+
+    free(pool->threads);
+    free(pool->workers);
+
+    *pool = (struct __graph_pool) {0};
+}
+
+static inline int __graph_atomic_min(size_t *target, size_t value)
+{
+    size_t current = __atomic_load_n(target, __ATOMIC_RELAXED);
+
+    while (value < current)
+    {
+        if (__atomic_compare_exchange_n(target, &current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return 1;
+    }
+
+    return 0;
+}
+
+// shortest distances from a single vertex
+
+graph_error_t graph_dijkstra(const struct graph *graph, const char *source, size_t *distances)
+{
+    if (!distances)
+        return _GRAPH_INCORRECT_ARG__;
+
+    struct __graph_csr csr;
+    size_t source_index = 0;
+
+    graph_error_t rc = __graph_csr_from_source(graph, source, _GRAPH_CSR_FORWARD__, &csr, &source_index);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    struct __graph_heap heap;
+
+    rc = __graph_heap_create(&heap, csr.vertices_amount);
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i < csr.vertices_amount; i++)
+            distances[i] = _GRAPH_INFINITY__;
+
+        distances[source_index] = 0;
+        __graph_heap_push(&heap, source_index, 0);
+
+        while (heap.size)
+        {
+            size_t vertex = __graph_heap_pop(&heap);
+            size_t distance = distances[vertex];
+
+            for (size_t i = csr.offsets[vertex]; i < csr.offsets[vertex + 1]; i++)
+            {
+                size_t target = csr.targets[i];
+
+                if (csr.lengths[i] < _GRAPH_INFINITY__ - distance && distance + csr.lengths[i] < distances[target])
+                {
+                    distances[target] = distance + csr.lengths[i];
+                    __graph_heap_push(&heap, target, distances[target]);
+                }
+            }
+        }
+
+        __graph_heap_free(&heap);
+    }
+
+    __graph_csr_free(&csr);
+
+    return rc;
+}
+
+struct __graph_delta_stepping
+{
+    const struct __graph_csr *csr;
+    const size_t *light_ends;
+    size_t *distances;
+    const size_t *frontier;
+    size_t frontier_size;
+    size_t next_chunk;
+    int heavy;
+    int memory_error;
+    struct __graph_buffer *improved;
+};
+
+static void __graph_delta_stepping_relax(void *context, size_t thread_index)
+{
+    struct __graph_delta_stepping *state = context;
+    const struct __graph_csr *csr = state->csr;
+    struct __graph_buffer *improved = &state->improved[thread_index];
+
+    for (;;)
+    {
+        size_t begin = __atomic_fetch_add(&state->next_chunk, _GRAPH_CHUNK_SIZE__, __ATOMIC_RELAXED);
+        if (begin >= state->frontier_size)
+            break;
+
+        size_t end = begin + _GRAPH_CHUNK_SIZE__ < state->frontier_size ? begin + _GRAPH_CHUNK_SIZE__ : state->frontier_size;
+
+        for (size_t i = begin; i < end; i++)
+        {
+            size_t vertex = state->frontier[i];
+            size_t distance = __atomic_load_n(&state->distances[vertex], __ATOMIC_RELAXED);
+
+            size_t first = state->heavy ? state->light_ends[vertex] : csr->offsets[vertex];
+            size_t last = state->heavy ? csr->offsets[vertex + 1] : state->light_ends[vertex];
+
+            for (size_t j = first; j < last; j++)
+            {
+                if (csr->lengths[j] >= _GRAPH_INFINITY__ - distance)
+                    continue;
+
+                if (__graph_atomic_min(&state->distances[csr->targets[j]], distance + csr->lengths[j]) \
+                    && __graph_buffer_push(improved, csr->targets[j]) != _GRAPH_OK__)
+                    __atomic_store_n(&state->memory_error, 1, __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+static graph_error_t __graph_bucket_insert(struct __graph_buffer *buckets, size_t buckets_amount, struct __graph_buffer *overflow, \
+    size_t current, size_t bucket, size_t vertex)
+{
+    if (bucket - current < buckets_amount)
+        return __graph_buffer_push(&buckets[bucket % buckets_amount], vertex);
+
+    return __graph_buffer_push(overflow, vertex);
+}
+
+static graph_error_t __graph_delta_stepping_run(struct __graph_pool *pool, struct __graph_delta_stepping *state, int heavy, \
+    const struct __graph_buffer *frontier, struct __graph_buffer *buckets, size_t buckets_amount, struct __graph_buffer *overflow, \
+    size_t current, size_t delta, size_t *pending)
+{
+    graph_error_t rc = _GRAPH_OK__;
+
+    state->frontier = frontier->values;
+    state->frontier_size = frontier->size;
+    state->next_chunk = 0;
+    state->heavy = heavy;
+
+    __graph_pool_run(pool, __graph_delta_stepping_relax, state);
+
+    if (state->memory_error)
+        rc = _GRAPH_MEM__;
+
+    // distributing improved vertices by buckets
+
+    for (size_t i = 0; i < pool->threads_amount; i++)
+    {
+        for (size_t j = 0; j < state->improved[i].size && rc == _GRAPH_OK__; j++)
+        {
+            size_t vertex = state->improved[i].values[j];
+            size_t bucket = state->distances[vertex] / delta;
+
+            rc = __graph_bucket_insert(buckets, buckets_amount, overflow, current, bucket, vertex);
+
+            if (rc == _GRAPH_OK__ && bucket - current < buckets_amount)
+                (*pending)++;
+        }
+
+        state->improved[i].size = 0;
+    }
+
+    return rc;
+}
+
+graph_error_t graph_delta_stepping(const struct graph *graph, const char *source, size_t delta, size_t threads_amount, size_t *distances)
+{
+    if (!distances)
+        return _GRAPH_INCORRECT_ARG__;
+
+    struct __graph_csr csr;
+    size_t source_index = 0;
+
+    graph_error_t rc = __graph_csr_from_source(graph, source, _GRAPH_CSR_FORWARD__, &csr, &source_index);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t vertices_amount = csr.vertices_amount;
+
+    // choosing bucket width
+
+    size_t max_length = 0;
+
+    for (size_t i = 0; i < csr.edges_amount; i++)
+        max_length = csr.lengths[i] > max_length ? csr.lengths[i] : max_length;
+
+    if (!delta)
+    {
+        size_t average_degree = csr.edges_amount / vertices_amount;
+
+        delta = max_length / (average_degree ? average_degree : 1);
+        delta = delta ? delta : 1;
+    }
+
+    size_t buckets_amount = max_length / delta + 2;
+    buckets_amount = buckets_amount < _GRAPH_BUCKETS_MAX__ ? buckets_amount : _GRAPH_BUCKETS_MAX__;
+
+    size_t *light_ends = malloc(vertices_amount * sizeof(size_t));
+    size_t *phase_stamps = calloc(vertices_amount, sizeof(size_t));
+    size_t *settled_stamps = calloc(vertices_amount, sizeof(size_t));
+    struct __graph_buffer *buckets = calloc(buckets_amount, sizeof(struct __graph_buffer));
+
+    struct __graph_buffer overflow = {0};
+    struct __graph_buffer frontier = {0};
+    struct __graph_buffer settled = {0};
+
+    struct __graph_pool pool = {0};
+    struct __graph_delta_stepping state = { .csr = &csr, .light_ends = light_ends, .distances = distances };
+
+    if (!light_ends || !phase_stamps || !settled_stamps || !buckets)
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_pool_create(&pool, __graph_threads_amount(threads_amount));
+
+    if (rc == _GRAPH_OK__)
+    {
+        state.improved = calloc(pool.threads_amount, sizeof(struct __graph_buffer));
+        if (!state.improved)
+            rc = _GRAPH_MEM__;
+    }
+
+    // splitting the edges of every vertex into light ones followed by heavy ones
+
+    for (size_t i = 0; i < vertices_amount && rc == _GRAPH_OK__; i++)
+    {
+        size_t light_end = csr.offsets[i];
+
+        for (size_t j = csr.offsets[i]; j < csr.offsets[i + 1]; j++)
+        {
+            if (csr.lengths[j] <= delta)
+            {
+                size_t target = csr.targets[j];
+                size_t length = csr.lengths[j];
+                size_t edge = csr.edges[j];
+
+                csr.targets[j] = csr.targets[light_end];
+                csr.lengths[j] = csr.lengths[light_end];
+                csr.edges[j] = csr.edges[light_end];
+                csr.targets[light_end] = target;
+                csr.lengths[light_end] = length;
+                csr.edges[light_end] = edge;
+
+                light_end++;
+            }
+        }
+
+        light_ends[i] = light_end;
+    }
+
+    size_t pending = 0;
+    size_t current = 0;
+    size_t phase = 0;
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i < vertices_amount; i++)
+            distances[i] = _GRAPH_INFINITY__;
+
+        distances[source_index] = 0;
+
+        rc = __graph_buffer_push(&buckets[0], source_index);
+        pending = 1;
+    }
+
+    while (rc == _GRAPH_OK__ && (pending || overflow.size))
+    {
+        // moving the window of buckets to the nearest vertices outside of it
+
+        if (!pending)
+        {
+            current = _GRAPH_INFINITY__;
+
+            for (size_t i = 0; i < overflow.size; i++)
+                current = distances[overflow.values[i]] / delta < current ? distances[overflow.values[i]] / delta : current;
+
+            struct __graph_buffer outside = overflow;
+            overflow = (struct __graph_buffer) {0};
+
+            for (size_t i = 0; i < outside.size && rc == _GRAPH_OK__; i++)
+            {
+                size_t bucket = distances[outside.values[i]] / delta;
+
+                rc = __graph_bucket_insert(buckets, buckets_amount, &overflow, current, bucket, outside.values[i]);
+
+                if (rc == _GRAPH_OK__ && bucket - current < buckets_amount)
+                    pending++;
+            }
+
+            free(outside.values);
+
+            continue;
+        }
+
+        while (!buckets[current % buckets_amount].size)
+            current++;
+
+        settled.size = 0;
+
+        // relaxing light edges until the current bucket stays empty
+
+        while (rc == _GRAPH_OK__ && buckets[current % buckets_amount].size)
+        {
+            struct __graph_buffer taken = buckets[current % buckets_amount];
+
+            frontier.size = 0;
+            buckets[current % buckets_amount] = frontier;
+            frontier = taken;
+            pending -= frontier.size;
+            phase++;
+
+            size_t frontier_size = 0;
+
+            for (size_t i = 0; i < frontier.size && rc == _GRAPH_OK__; i++)
+            {
+                size_t vertex = frontier.values[i];
+
+                if (distances[vertex] / delta != current || phase_stamps[vertex] == phase)
+                    continue;
+
+                phase_stamps[vertex] = phase;
+                frontier.values[frontier_size++] = vertex;
+
+                if (settled_stamps[vertex] != current + 1)
+                {
+                    settled_stamps[vertex] = current + 1;
+                    rc = __graph_buffer_push(&settled, vertex);
+                }
+            }
+
+            frontier.size = frontier_size;
+
+            if (rc == _GRAPH_OK__)
+                rc = __graph_delta_stepping_run(&pool, &state, 0, &frontier, buckets, buckets_amount, &overflow, current, delta, &pending);
+        }
+
+        // relaxing heavy edges of the vertices settled in the current bucket
+
+        if (rc == _GRAPH_OK__)
+            rc = __graph_delta_stepping_run(&pool, &state, 1, &settled, buckets, buckets_amount, &overflow, current, delta, &pending);
+
+        current++;
+    }
+
+    for (size_t i = 0; state.improved && i < pool.threads_amount; i++)
+        free(state.improved[i].values);
+
+    for (size_t i = 0; buckets && i < buckets_amount; i++)
+        free(buckets[i].values);
+
+    __graph_pool_free(&pool);
+
+    free(state.improved);
+    free(overflow.values);
+    free(frontier.values);
+    free(settled.values);
+    free(buckets);
+    free(settled_stamps);
+    free(phase_stamps);
+    free(light_ends);
+
+    __graph_csr_free(&csr);
+
+    return rc;
+}
+
+// shortest path between two vertices
+
+static graph_error_t __graph_csr_from_endpoints(const struct graph *graph, const char *source, const char *destination, \
+    struct __graph_csr *forward, struct __graph_csr *reverse, size_t *source_index, size_t *destination_index)
+{
+    if (!graph || !source || !strlen(source) || !destination || !strlen(destination))
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    struct __graph_name *names = __graph_names_create(graph);
+    if (!names)
+        return _GRAPH_MEM__;
+
+    *source_index = __graph_names_find(names, graph->vertices_amount, source);
+    *destination_index = __graph_names_find(names, graph->vertices_amount, destination);
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (*source_index == graph->vertices_amount || *destination_index == graph->vertices_amount)
+        rc = _GRAPH_NOT_FOUND__;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_csr_create(graph, names, _GRAPH_CSR_FORWARD__, forward);
+
+    if (rc == _GRAPH_OK__ && reverse)
+    {
+        rc = __graph_csr_create(graph, names, _GRAPH_CSR_REVERSE__, reverse);
+        if (rc != _GRAPH_OK__)
+            __graph_csr_free(forward);
+    }
+
+    free(names);
+
+    return rc;
+}
+
+static graph_error_t __graph_path_fill(struct graph_path *path, const size_t *forward_parents, const size_t *reverse_parents, \
+    size_t meeting_vertex, size_t length)
+{
+    size_t vertices_amount = 1;
+
+    for (size_t i = meeting_vertex; forward_parents[i] != _GRAPH_NO_POSITION__; i = forward_parents[i])
+        vertices_amount++;
+
+    for (size_t i = meeting_vertex; reverse_parents && reverse_parents[i] != _GRAPH_NO_POSITION__; i = reverse_parents[i])
+        vertices_amount++;
+
+    path->vertices = malloc(vertices_amount * sizeof(size_t));
+    if (!path->vertices)
+        return _GRAPH_MEM__;
+
+    size_t position = 0;
+
+    for (size_t i = meeting_vertex; forward_parents[i] != _GRAPH_NO_POSITION__; i = forward_parents[i])
+        position++;
+
+    path->vertices[position] = meeting_vertex;
+
+    for (size_t i = meeting_vertex, k = position; forward_parents[i] != _GRAPH_NO_POSITION__; i = forward_parents[i])
+        path->vertices[--k] = forward_parents[i];
+
+    for (size_t i = meeting_vertex; reverse_parents && reverse_parents[i] != _GRAPH_NO_POSITION__; i = reverse_parents[i])
+        path->vertices[++position] = reverse_parents[i];
+
+    path->vertices_amount = vertices_amount;
+    path->length = length;
+
+    return _GRAPH_OK__;
+}
+
+graph_error_t graph_shortest_path(const struct graph *graph, const char *source, const char *destination, struct graph_path *path)
+{
+    if (!path)
+        return _GRAPH_INCORRECT_ARG__;
+
+    *path = (struct graph_path) {0};
+
+    struct __graph_csr csr[2];
+    size_t endpoints[2];
+
+    graph_error_t rc = __graph_csr_from_endpoints(graph, source, destination, &csr[0], &csr[1], &endpoints[0], &endpoints[1]);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t vertices_amount = csr[0].vertices_amount;
+
+    // index 0 - forward search from the source, index 1 - backward search from the destination
+
+    struct __graph_heap heap[2] = {0};
+    size_t *distances[2] = { malloc(vertices_amount * sizeof(size_t)), malloc(vertices_amount * sizeof(size_t)) };
+    size_t *parents[2] = { malloc(vertices_amount * sizeof(size_t)), malloc(vertices_amount * sizeof(size_t)) };
+
+    if (!distances[0] || !distances[1] || !parents[0] || !parents[1])
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_heap_create(&heap[0], vertices_amount);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_heap_create(&heap[1], vertices_amount);
+
+    size_t best_length = _GRAPH_INFINITY__;
+    size_t meeting_vertex = endpoints[0];
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t side = 0; side < 2; side++)
+        {
+            for (size_t i = 0; i < vertices_amount; i++)
+            {
+                distances[side][i] = _GRAPH_INFINITY__;
+                parents[side][i] = _GRAPH_NO_POSITION__;
+            }
+
+            distances[side][endpoints[side]] = 0;
+            __graph_heap_push(&heap[side], endpoints[side], 0);
+        }
+
+        if (endpoints[0] == endpoints[1])
+            best_length = 0;
+    }
+
+    while (rc == _GRAPH_OK__ && heap[0].size && heap[1].size)
+    {
+        size_t forward_minimum = heap[0].keys[heap[0].vertices[0]];
+        size_t reverse_minimum = heap[1].keys[heap[1].vertices[0]];
+
+        // no path through unsettled vertices can be shorter than the best one
+
+        if (forward_minimum >= best_length || reverse_minimum >= best_length - forward_minimum)
+            break;
+
+        size_t side = forward_minimum <= reverse_minimum ? 0 : 1;
+        size_t vertex = __graph_heap_pop(&heap[side]);
+        size_t distance = distances[side][vertex];
+
+        for (size_t i = csr[side].offsets[vertex]; i < csr[side].offsets[vertex + 1]; i++)
+        {
+            size_t target = csr[side].targets[i];
+
+            if (csr[side].lengths[i] >= _GRAPH_INFINITY__ - distance)
+                continue;
+
+            if (distance + csr[side].lengths[i] < distances[side][target])
+            {
+                distances[side][target] = distance + csr[side].lengths[i];
+                parents[side][target] = vertex;
+                __graph_heap_push(&heap[side], target, distances[side][target]);
+            }
+
+            size_t opposite_distance = distances[1 - side][target];
+
+            if (opposite_distance != _GRAPH_INFINITY__ && opposite_distance < best_length \
+                && distances[side][target] < best_length - opposite_distance)
+            {
+                best_length = distances[side][target] + opposite_distance;
+                meeting_vertex = target;
+            }
+        }
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        if (best_length == _GRAPH_INFINITY__)
+            rc = _GRAPH_NOT_FOUND__;
+        else
+            rc = __graph_path_fill(path, parents[0], parents[1], meeting_vertex, best_length);
+    }
+
+    for (size_t side = 0; side < 2; side++)
+    {
+        __graph_heap_free(&heap[side]);
+        __graph_csr_free(&csr[side]);
+        free(distances[side]);
+        free(parents[side]);
+    }
+
+    return rc;
+}
+
+graph_error_t graph_shortest_path_astar(const struct graph *graph, const char *source, const char *destination, \
+    size_t (*heuristic)(const char *vertex, const char *destination, void *context), void *context, struct graph_path *path)
+{
+    if (!path || !heuristic)
+        return _GRAPH_INCORRECT_ARG__;
+
+    *path = (struct graph_path) {0};
+
+    struct __graph_csr csr;
+    size_t source_index = 0;
+    size_t destination_index = 0;
+
+    graph_error_t rc = __graph_csr_from_endpoints(graph, source, destination, &csr, NULL, &source_index, &destination_index);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t vertices_amount = csr.vertices_amount;
+
+    struct __graph_heap heap = {0};
+    size_t *distances = malloc(vertices_amount * sizeof(size_t));
+    size_t *parents = malloc(vertices_amount * sizeof(size_t));
+    size_t *estimates = malloc(vertices_amount * sizeof(size_t));
+
+    if (!distances || !parents || !estimates)
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_heap_create(&heap, vertices_amount);
+
+    if (rc == _GRAPH_OK__)
+    {
+        // the estimate is computed lazily, infinity marks a vertex that was not estimated yet
+
+        for (size_t i = 0; i < vertices_amount; i++)
+        {
+            distances[i] = _GRAPH_INFINITY__;
+            parents[i] = _GRAPH_NO_POSITION__;
+            estimates[i] = _GRAPH_INFINITY__;
+        }
+
+        distances[source_index] = 0;
+        __graph_heap_push(&heap, source_index, 0);
+    }
+
+    int found = 0;
+
+    while (rc == _GRAPH_OK__ && heap.size && !found)
+    {
+        size_t vertex = __graph_heap_pop(&heap);
+        size_t distance = distances[vertex];
+
+        if (vertex == destination_index)
+        {
+            found = 1;
+            continue;
+        }
+
+        for (size_t i = csr.offsets[vertex]; i < csr.offsets[vertex + 1]; i++)
+        {
+            size_t target = csr.targets[i];
+
+            if (csr.lengths[i] >= _GRAPH_INFINITY__ - distance || distance + csr.lengths[i] >= distances[target])
+                continue;
+
+            distances[target] = distance + csr.lengths[i];
+            parents[target] = vertex;
+
+            if (estimates[target] == _GRAPH_INFINITY__)
+                estimates[target] = heuristic(graph->vertices[target], destination, context);
+
+            size_t key = estimates[target] < _GRAPH_INFINITY__ - distances[target] ? distances[target] + estimates[target] : _GRAPH_INFINITY__;
+
+            __graph_heap_push(&heap, target, key);
+        }
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        if (!found)
+            rc = _GRAPH_NOT_FOUND__;
+        else
+            rc = __graph_path_fill(path, parents, NULL, destination_index, distances[destination_index]);
+    }
+
+    __graph_heap_free(&heap);
+    __graph_csr_free(&csr);
+
+    free(estimates);
+    free(parents);
+    free(distances);
+
+    return rc;
+}
+
+void graph_path_free(struct graph_path *path)
+{
+    if (path)
+    {
+        free(path->vertices);
+        *path = (struct graph_path) {0};
+    }
+}
+
+// shortest paths between all pairs of vertices
+
+struct graph_paths
+{
+    const struct graph *graph;
+    size_t generation;
+    int computed;
+    int packed;
+    size_t vertices_amount;
+    struct __graph_name *names;
+    size_t *distances;
+    void *next_vertices;
+    size_t next_vertex_size;
+    struct __graph_csr csr;
+    size_t *stamps;
+    size_t epoch;
+};
+
+/**
+ * Distances of undirected graph are symmetric and packed into the upper triangle by rows
+*/
+static inline size_t __graph_paths_position(size_t vertices_amount, int packed, size_t source, size_t destination)
+{
+    if (!packed)
+        return source * vertices_amount + destination;
+
+    if (source > destination)
+    {
+        size_t tmp = source;
+        source = destination;
+        destination = tmp;
+    }
+
+    return source * (2 * vertices_amount - source + 1) / 2 + destination - source;
+}
+
+/**
+ * Floyd-Warshall algorithm on the packed upper triangle: the row of the intermediate vertex is unpacked once per step,
+ * so that every row of the triangle is updated contiguously
+*/
+static graph_error_t __graph_floyd_warshall_packed(const struct __graph_csr *csr, size_t *distances)
+{
+    size_t vertices_amount = csr->vertices_amount;
+
+    size_t *row_k = malloc((vertices_amount + 1) * sizeof(size_t));
+    if (!row_k)
+        return _GRAPH_MEM__;
+
+    for (size_t i = 0; i < vertices_amount * (vertices_amount + 1) / 2; i++)
+        distances[i] = _GRAPH_INFINITY__;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+    {
+        distances[__graph_paths_position(vertices_amount, 1, i, i)] = 0;
+
+        for (size_t j = csr->offsets[i]; j < csr->offsets[i + 1]; j++)
+        {
+            size_t position = __graph_paths_position(vertices_amount, 1, i, csr->targets[j]);
+
+            if (csr->lengths[j] < distances[position])
+                distances[position] = csr->lengths[j];
+        }
+    }
+
+    for (size_t k = 0; k < vertices_amount; k++)
+    {
+        for (size_t j = 0; j < vertices_amount; j++)
+            row_k[j] = distances[__graph_paths_position(vertices_amount, 1, k, j)];
+
+        for (size_t i = 0; i < vertices_amount; i++)
+        {
+            size_t distance_ik = row_k[i];
+
+            if (distance_ik == _GRAPH_INFINITY__ || i == k)
+                continue;
+
+            size_t *row_i = distances + __graph_paths_position(vertices_amount, 1, i, i) - i;
+
+            for (size_t j = i; j < vertices_amount; j++)
+            {
+                if (row_k[j] < _GRAPH_INFINITY__ - distance_ik && distance_ik + row_k[j] < row_i[j])
+                    row_i[j] = distance_ik + row_k[j];
+            }
+        }
+    }
+
+    free(row_k);
+
+    return _GRAPH_OK__;
+}
+
+/**
+ * Floyd-Warshall algorithm recording the next vertex of every shortest path in a matrix of the given type
+*/
+#define _GRAPH_FLOYD_WARSHALL__(suffix, type, none)                                                                     \
+static void __graph_floyd_warshall_##suffix(const struct __graph_csr *csr, size_t *distances, void *next_matrix)      \
+{                                                                                                                       \
+    size_t vertices_amount = csr->vertices_amount;                                                                      \
+    type *next_vertices = next_matrix;                                                                                  \
+                                                                                                                        \
+    for (size_t i = 0; i < vertices_amount * vertices_amount; i++)                                                      \
+    {                                                                                                                   \
+        distances[i] = _GRAPH_INFINITY__;                                                                               \
+        next_vertices[i] = none;                                                                                        \
+    }                                                                                                                   \
+                                                                                                                        \
+    for (size_t i = 0; i < vertices_amount; i++)                                                                        \
+    {                                                                                                                   \
+        distances[i * vertices_amount + i] = 0;                                                                         \
+        next_vertices[i * vertices_amount + i] = (type) i;                                                              \
+                                                                                                                        \
+        for (size_t j = csr->offsets[i]; j < csr->offsets[i + 1]; j++)                                                  \
+        {                                                                                                               \
+            size_t position = i * vertices_amount + csr->targets[j];                                                    \
+                                                                                                                        \
+            if (csr->lengths[j] < distances[position])                                                                  \
+            {                                                                                                           \
+                distances[position] = csr->lengths[j];                                                                 \
+                next_vertices[position] = (type) csr->targets[j];                                                       \
+            }                                                                                                           \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    for (size_t k = 0; k < vertices_amount; k++)                                                                        \
+    {                                                                                                                   \
+        const size_t *row_k = distances + k * vertices_amount;                                                          \
+                                                                                                                        \
+        for (size_t i = 0; i < vertices_amount; i++)                                                                    \
+        {                                                                                                               \
+            size_t *row_i = distances + i * vertices_amount;                                                            \
+            type *next_row_i = next_vertices + i * vertices_amount;                                                     \
+            size_t distance_ik = row_i[k];                                                                              \
+                                                                                                                        \
+            if (distance_ik == _GRAPH_INFINITY__ || i == k)                                                             \
+                continue;                                                                                               \
+                                                                                                                        \
+            type next_vertex = next_row_i[k];                                                                           \
+                                                                                                                        \
+            for (size_t j = 0; j < vertices_amount; j++)                                                                \
+            {                                                                                                           \
+                if (row_k[j] < _GRAPH_INFINITY__ - distance_ik && distance_ik + row_k[j] < row_i[j])                    \
+                {                                                                                                       \
+                    row_i[j] = distance_ik + row_k[j];                                                                  \
+                    next_row_i[j] = next_vertex;                                                                        \
+                }                                                                                                       \
+            }                                                                                                           \
+        }                                                                                                               \
+    }                                                                                                                   \
+}
+
+_GRAPH_FLOYD_WARSHALL__(8, uint8_t, UINT8_MAX)
+_GRAPH_FLOYD_WARSHALL__(16, uint16_t, UINT16_MAX)
+_GRAPH_FLOYD_WARSHALL__(32, uint32_t, UINT32_MAX)
+_GRAPH_FLOYD_WARSHALL__(64, uint64_t, UINT64_MAX)
+
+static inline size_t __graph_paths_next_vertex(const struct graph_paths *paths, size_t source, size_t destination)
+{
+    size_t position = source * paths->vertices_amount + destination;
+
+    switch (paths->next_vertex_size)
+    {
+        case sizeof(uint8_t):
+            return ((const uint8_t *) paths->next_vertices)[position];
+        case sizeof(uint16_t):
+            return ((const uint16_t *) paths->next_vertices)[position];
+        case sizeof(uint32_t):
+            return ((const uint32_t *) paths->next_vertices)[position];
+        default:
+            return ((const uint64_t *) paths->next_vertices)[position];
+    }
+}
+
+static void __graph_paths_clear(struct graph_paths *paths)
+{
+    __graph_csr_free(&paths->csr);
+
+    free(paths->names);
+    free(paths->distances);
+    free(paths->next_vertices);
+    free(paths->stamps);
+
+    paths->names = NULL;
+    paths->distances = NULL;
+    paths->next_vertices = NULL;
+    paths->stamps = NULL;
+    paths->computed = 0;
+}
+
+static graph_error_t __graph_paths_update(struct graph_paths *paths)
+{
+    const struct graph *graph = paths->graph;
+
+    if (paths->computed && paths->generation == graph->generation)
+        return _GRAPH_OK__;
+
+    __graph_paths_clear(paths);
+
+    size_t vertices_amount = graph->vertices_amount;
+
+    // the largest value of the type is reserved for the absence of path
+
+    if (vertices_amount < UINT8_MAX)
+        paths->next_vertex_size = sizeof(uint8_t);
+    else if (vertices_amount < UINT16_MAX)
+        paths->next_vertex_size = sizeof(uint16_t);
+    else if (vertices_amount < UINT32_MAX)
+        paths->next_vertex_size = sizeof(uint32_t);
+    else
+        paths->next_vertex_size = sizeof(uint64_t);
+
+    struct __graph_csr csr = {0};
+
+    paths->packed = graph->mode == _GRAPH_UNDIRECTED__;
+    paths->names = __graph_names_create(graph);
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    // undirected graph keeps half of distances, paths are restored by edges instead of next vertices
+
+    if (paths->packed)
+    {
+        paths->distances = malloc((vertices_amount * (vertices_amount + 1) / 2 + 1) * sizeof(size_t));
+        paths->stamps = calloc(vertices_amount + 1, sizeof(size_t));
+        paths->epoch = 0;
+
+        if (!paths->names || !paths->distances || !paths->stamps)
+            rc = _GRAPH_MEM__;
+
+        if (rc == _GRAPH_OK__)
+            rc = __graph_csr_create(graph, paths->names, _GRAPH_CSR_FORWARD__, &paths->csr);
+
+        if (rc == _GRAPH_OK__)
+            rc = __graph_floyd_warshall_packed(&paths->csr, paths->distances);
+    }
+    else
+    {
+        paths->distances = malloc((vertices_amount * vertices_amount + 1) * sizeof(size_t));
+        paths->next_vertices = malloc((vertices_amount * vertices_amount + 1) * paths->next_vertex_size);
+
+        if (!paths->names || !paths->distances || !paths->next_vertices)
+            rc = _GRAPH_MEM__;
+
+        if (rc == _GRAPH_OK__)
+            rc = __graph_csr_create(graph, paths->names, _GRAPH_CSR_FORWARD__, &csr);
+    }
+
+    if (rc == _GRAPH_OK__ && !paths->packed)
+    {
+        switch (paths->next_vertex_size)
+        {
+            case sizeof(uint8_t):
+                __graph_floyd_warshall_8(&csr, paths->distances, paths->next_vertices);
+                break;
+            case sizeof(uint16_t):
+                __graph_floyd_warshall_16(&csr, paths->distances, paths->next_vertices);
+                break;
+            case sizeof(uint32_t):
+                __graph_floyd_warshall_32(&csr, paths->distances, paths->next_vertices);
+                break;
+            default:
+                __graph_floyd_warshall_64(&csr, paths->distances, paths->next_vertices);
+        }
+
+        __graph_csr_free(&csr);
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        paths->vertices_amount = vertices_amount;
+        paths->generation = graph->generation;
+        paths->computed = 1;
+    }
+    else
+        __graph_paths_clear(paths);
+
+    return rc;
+}
+
+/**
+ * Depth-first search along edges lying on shortest paths to the destination,
+ * visited vertices are skipped so that edges of zero length can not loop
+*/
+static graph_error_t __graph_paths_walk(struct graph_paths *paths, size_t source, size_t destination, size_t length, \
+    struct graph_path *path)
+{
+    const struct __graph_csr *csr = &paths->csr;
+    size_t vertices_amount = paths->vertices_amount;
+
+    if (!++paths->epoch)
+    {
+        memset(paths->stamps, 0, vertices_amount * sizeof(size_t));
+        paths->epoch = 1;
+    }
+
+    struct __graph_buffer vertices = {0};
+    struct __graph_buffer positions = {0};
+
+    graph_error_t rc = __graph_buffer_push(&vertices, source);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_buffer_push(&positions, csr->offsets[source]);
+
+    paths->stamps[source] = paths->epoch;
+
+    while (rc == _GRAPH_OK__ && vertices.values[vertices.size - 1] != destination)
+    {
+        size_t vertex = vertices.values[vertices.size - 1];
+        size_t remaining = paths->distances[__graph_paths_position(vertices_amount, 1, vertex, destination)];
+        size_t found = vertices_amount;
+
+        while (positions.values[positions.size - 1] < csr->offsets[vertex + 1] && found == vertices_amount)
+        {
+            size_t i = positions.values[positions.size - 1]++;
+            size_t target = csr->targets[i];
+            size_t target_remaining = paths->distances[__graph_paths_position(vertices_amount, 1, target, destination)];
+
+            if (paths->stamps[target] != paths->epoch && target_remaining != _GRAPH_INFINITY__ \
+                && csr->lengths[i] <= remaining && csr->lengths[i] + target_remaining == remaining)
+                found = target;
+        }
+
+        if (found == vertices_amount)
+        {
+            vertices.size--;
+            positions.size--;
+
+            continue;
+        }
+
+        paths->stamps[found] = paths->epoch;
+
+        rc = __graph_buffer_push(&vertices, found);
+
+        if (rc == _GRAPH_OK__)
+            rc = __graph_buffer_push(&positions, csr->offsets[found]);
+    }
+
+    free(positions.values);
+
+    if (rc != _GRAPH_OK__)
+    {
+        free(vertices.values);
+        return rc;
+    }
+
+    path->vertices = vertices.values;
+    path->vertices_amount = vertices.size;
+    path->length = length;
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_paths_find(struct graph_paths *paths, const char *source, const char *destination, \
+    size_t *source_index, size_t *destination_index)
+{
+    if (!paths || !source || !strlen(source) || !destination || !strlen(destination))
+        return _GRAPH_INCORRECT_ARG__;
+
+    graph_error_t rc = __graph_paths_update(paths);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    *source_index = __graph_names_find(paths->names, paths->vertices_amount, source);
+    *destination_index = __graph_names_find(paths->names, paths->vertices_amount, destination);
+
+    if (*source_index == paths->vertices_amount || *destination_index == paths->vertices_amount)
+        return _GRAPH_NOT_FOUND__;
+
+    return _GRAPH_OK__;
+}
+
+struct graph_paths *graph_paths_create(const struct graph *graph)
+{
+    if (!graph)
+        return NULL;
+
+    struct graph_paths *paths = calloc(1, sizeof(struct graph_paths));
+    if (!paths)
+        return NULL;
+
+    paths->graph = graph;
+
+    if (__graph_paths_update(paths) != _GRAPH_OK__)
+    {
+        free(paths);
+        return NULL;
+    }
+
+    return paths;
+}
+
+graph_error_t graph_paths_distance(struct graph_paths *paths, const char *source, const char *destination, size_t *distance)
+{
+    if (!distance)
+        return _GRAPH_INCORRECT_ARG__;
+
+    size_t source_index = 0;
+    size_t destination_index = 0;
+
+    graph_error_t rc = __graph_paths_find(paths, source, destination, &source_index, &destination_index);
+
+    if (rc == _GRAPH_OK__)
+        *distance = paths->distances[__graph_paths_position(paths->vertices_amount, paths->packed, source_index, destination_index)];
+
+    return rc;
+}
+
+graph_error_t graph_paths_path(struct graph_paths *paths, const char *source, const char *destination, struct graph_path *path)
+{
+    if (!path)
+        return _GRAPH_INCORRECT_ARG__;
+
+    *path = (struct graph_path) {0};
+
+    size_t source_index = 0;
+    size_t destination_index = 0;
+
+    graph_error_t rc = __graph_paths_find(paths, source, destination, &source_index, &destination_index);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t length = paths->distances[__graph_paths_position(paths->vertices_amount, paths->packed, source_index, destination_index)];
+    if (length == _GRAPH_INFINITY__)
+        return _GRAPH_NOT_FOUND__;
+
+    if (paths->packed)
+        return __graph_paths_walk(paths, source_index, destination_index, length, path);
+
+    // following next vertices twice: to count them and to write them
+
+    size_t vertices_amount = 1;
+
+    for (size_t i = source_index; i != destination_index; i = __graph_paths_next_vertex(paths, i, destination_index))
+        vertices_amount++;
+
+    path->vertices = malloc(vertices_amount * sizeof(size_t));
+    if (!path->vertices)
+        return _GRAPH_MEM__;
+
+    path->vertices[0] = source_index;
+
+    for (size_t i = 1; i < vertices_amount; i++)
+        path->vertices[i] = __graph_paths_next_vertex(paths, path->vertices[i - 1], destination_index);
+
+    path->vertices_amount = vertices_amount;
+    path->length = length;
+
+    return _GRAPH_OK__;
+}
+
+void graph_paths_free(struct graph_paths *paths)
+{
+    if (paths)
+        __graph_paths_clear(paths);
+
+    free(paths);
+}
+
+// minimum spanning forest
+
+static size_t __graph_union_find(size_t *parents, size_t vertex)
+{
+    size_t root = vertex;
+
+    while (parents[root] != root)
+        root = parents[root];
+
+    // path compression
+
+    while (parents[vertex] != root)
+    {
+        size_t next = parents[vertex];
+        parents[vertex] = root;
+        vertex = next;
+    }
+
+    return root;
+}
+
+static int __graph_union(size_t *parents, unsigned char *ranks, size_t first, size_t second)
+{
+    first = __graph_union_find(parents, first);
+    second = __graph_union_find(parents, second);
+
+    if (first == second)
+        return 0;
+
+    if (ranks[first] < ranks[second])
+    {
+        size_t tmp = first;
+        first = second;
+        second = tmp;
+    }
+
+    parents[second] = first;
+
+    if (ranks[first] == ranks[second])
+        ranks[first]++;
+
+    return 1;
+}
+
+struct __graph_radix_sort
+{
+    const struct edge *edges;
+    const size_t *input;
+    size_t *output;
+    size_t amount;
+    size_t threads_amount;
+    unsigned shift;
+    size_t *counters;
+};
+
+static void __graph_radix_sort_count(void *context, size_t thread_index)
+{
+    struct __graph_radix_sort *sort = context;
+    size_t *counters = sort->counters + (thread_index << _GRAPH_RADIX_BITS__);
+
+    size_t begin = sort->amount * thread_index / sort->threads_amount;
+    size_t end = sort->amount * (thread_index + 1) / sort->threads_amount;
+
+    memset(counters, 0, sizeof(size_t) << _GRAPH_RADIX_BITS__);
+
+    for (size_t i = begin; i < end; i++)
+        counters[(sort->edges[sort->input[i]].length >> sort->shift) & ((1 << _GRAPH_RADIX_BITS__) - 1)]++;
+}
+
+static void __graph_radix_sort_scatter(void *context, size_t thread_index)
+{
+    struct __graph_radix_sort *sort = context;
+    size_t *counters = sort->counters + (thread_index << _GRAPH_RADIX_BITS__);
+
+    size_t begin = sort->amount * thread_index / sort->threads_amount;
+    size_t end = sort->amount * (thread_index + 1) / sort->threads_amount;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        size_t digit = (sort->edges[sort->input[i]].length >> sort->shift) & ((1 << _GRAPH_RADIX_BITS__) - 1);
+
+        sort->output[counters[digit]++] = sort->input[i];
+    }
+}
+
+static graph_error_t __graph_mst_kruskal(const struct graph *graph, const size_t *starts, const size_t *ends, \
+    struct __graph_pool *pool, struct graph_spanning_forest *forest)
+{
+    size_t edges_amount = graph->edges_amount;
+    size_t vertices_amount = graph->vertices_amount;
+
+    size_t *order = malloc((edges_amount + 1) * sizeof(size_t));
+    size_t *buffer = malloc((edges_amount + 1) * sizeof(size_t));
+    size_t *counters = malloc((pool->threads_amount << _GRAPH_RADIX_BITS__) * sizeof(size_t));
+    size_t *parents = malloc(vertices_amount * sizeof(size_t));
+    unsigned char *ranks = calloc(vertices_amount, sizeof(unsigned char));
+
+    if (!order || !buffer || !counters || !parents || !ranks)
+    {
+        free(order);
+        free(buffer);
+        free(counters);
+        free(parents);
+        free(ranks);
+
+        return _GRAPH_MEM__;
+    }
+
+    size_t max_length = 0;
+
+    for (size_t i = 0; i < edges_amount; i++)
+    {
+        order[i] = i;
+        max_length = graph->edges[i].length > max_length ? graph->edges[i].length : max_length;
+    }
+
+    // stable least significant digit radix sort of edges by length
+
+    struct __graph_radix_sort sort = { graph->edges, order, buffer, edges_amount, pool->threads_amount, 0, counters };
+
+    for (unsigned shift = 0; shift < 8 * sizeof(size_t) && (max_length >> shift); shift += _GRAPH_RADIX_BITS__)
+    {
+        sort.shift = shift;
+
+        __graph_pool_run(pool, __graph_radix_sort_count, &sort);
+
+        // turning counters into the first positions of every digit for every thread
+
+        size_t position = 0;
+
+        for (size_t digit = 0; digit < (1 << _GRAPH_RADIX_BITS__); digit++)
+        {
+            for (size_t thread = 0; thread < pool->threads_amount; thread++)
+            {
+                size_t amount = counters[(thread << _GRAPH_RADIX_BITS__) + digit];
+
+                counters[(thread << _GRAPH_RADIX_BITS__) + digit] = position;
+                position += amount;
+            }
+        }
+
+        __graph_pool_run(pool, __graph_radix_sort_scatter, &sort);
+
+        size_t *tmp = (size_t *) sort.input;
+        sort.input = sort.output;
+        sort.output = tmp;
+    }
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        parents[i] = i;
+
+    for (size_t i = 0; i < edges_amount; i++)
+    {
+        size_t edge = sort.input[i];
+
+        if (starts[edge] != vertices_amount && __graph_union(parents, ranks, starts[edge], ends[edge]))
+        {
+            forest->edges[forest->edges_amount++] = edge;
+            forest->length += graph->edges[edge].length;
+        }
+    }
+
+    free(order);
+    free(buffer);
+    free(counters);
+    free(parents);
+    free(ranks);
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_mst_prim(const struct graph *graph, struct graph_spanning_forest *forest)
+{
+    size_t vertices_amount = graph->vertices_amount;
+
+    struct __graph_name *names = __graph_names_create(graph);
+    if (!names)
+        return _GRAPH_MEM__;
+
+    struct __graph_csr csr;
+    graph_error_t rc = __graph_csr_create(graph, names, _GRAPH_CSR_BOTH__, &csr);
+
+    free(names);
+
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    struct __graph_heap heap;
+    size_t *keys = malloc(vertices_amount * sizeof(size_t));
+    size_t *parent_edges = malloc(vertices_amount * sizeof(size_t));
+    unsigned char *in_tree = calloc(vertices_amount, sizeof(unsigned char));
+
+    rc = __graph_heap_create(&heap, vertices_amount);
+
+    if (rc == _GRAPH_OK__ && (!keys || !parent_edges || !in_tree))
+    {
+        __graph_heap_free(&heap);
+        rc = _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i < vertices_amount; i++)
+        {
+            keys[i] = _GRAPH_INFINITY__;
+            parent_edges[i] = _GRAPH_NO_POSITION__;
+        }
+
+        // growing a tree from every vertex not covered yet
+
+        for (size_t root = 0; root < vertices_amount; root++)
+        {
+            if (in_tree[root])
+                continue;
+
+            keys[root] = 0;
+            __graph_heap_push(&heap, root, 0);
+
+            while (heap.size)
+            {
+                size_t vertex = __graph_heap_pop(&heap);
+
+                in_tree[vertex] = 1;
+
+                if (parent_edges[vertex] != _GRAPH_NO_POSITION__)
+                {
+                    forest->edges[forest->edges_amount++] = parent_edges[vertex];
+                    forest->length += graph->edges[parent_edges[vertex]].length;
+                }
+
+                for (size_t i = csr.offsets[vertex]; i < csr.offsets[vertex + 1]; i++)
+                {
+                    size_t target = csr.targets[i];
+
+                    if (!in_tree[target] && csr.lengths[i] < keys[target])
+                    {
+                        keys[target] = csr.lengths[i];
+                        parent_edges[target] = csr.edges[i];
+                        __graph_heap_push(&heap, target, keys[target]);
+                    }
+                }
+            }
+        }
+
+        __graph_heap_free(&heap);
+    }
+
+    free(keys);
+    free(parent_edges);
+    free(in_tree);
+
+    __graph_csr_free(&csr);
+
+    return rc;
+}
+
+struct __graph_boruvka
+{
+    const struct graph *graph;
+    const size_t *starts;
+    const size_t *ends;
+    const size_t *components;
+    size_t *cheapest;
+    size_t threads_amount;
+};
+
+static inline int __graph_boruvka_lighter(const struct graph *graph, size_t first, size_t second)
+{
+    // ties are broken by edge index, so the chosen edges never form a cycle
+
+    if (second == _GRAPH_NO_POSITION__)
+        return 1;
+
+    if (graph->edges[first].length != graph->edges[second].length)
+        return graph->edges[first].length < graph->edges[second].length;
+
+    return first < second;
+}
+
+static inline void __graph_boruvka_offer(const struct graph *graph, size_t *cheapest, size_t edge)
+{
+    size_t current = __atomic_load_n(cheapest, __ATOMIC_RELAXED);
+
+    while (__graph_boruvka_lighter(graph, edge, current))
+    {
+        if (__atomic_compare_exchange_n(cheapest, &current, edge, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            break;
+    }
+}
+
+static void __graph_boruvka_cheapest(void *context, size_t thread_index)
+{
+    struct __graph_boruvka *boruvka = context;
+
+    size_t edges_amount = boruvka->graph->edges_amount;
+    size_t vertices_amount = boruvka->graph->vertices_amount;
+
+    size_t begin = edges_amount * thread_index / boruvka->threads_amount;
+    size_t end = edges_amount * (thread_index + 1) / boruvka->threads_amount;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        if (boruvka->starts[i] == vertices_amount)
+            continue;
+
+        size_t start_component = boruvka->components[boruvka->starts[i]];
+        size_t end_component = boruvka->components[boruvka->ends[i]];
+
+        if (start_component == end_component)
+            continue;
+
+        __graph_boruvka_offer(boruvka->graph, &boruvka->cheapest[start_component], i);
+        __graph_boruvka_offer(boruvka->graph, &boruvka->cheapest[end_component], i);
+    }
+}
+
+static graph_error_t __graph_mst_boruvka(const struct graph *graph, const size_t *starts, const size_t *ends, \
+    struct __graph_pool *pool, struct graph_spanning_forest *forest)
+{
+    size_t vertices_amount = graph->vertices_amount;
+
+    size_t *parents = malloc(vertices_amount * sizeof(size_t));
+    size_t *components = malloc(vertices_amount * sizeof(size_t));
+    size_t *cheapest = malloc(vertices_amount * sizeof(size_t));
+    unsigned char *ranks = calloc(vertices_amount, sizeof(unsigned char));
+
+    if (!parents || !components || !cheapest || !ranks)
+    {
+        free(parents);
+        free(components);
+        free(cheapest);
+        free(ranks);
+
+        return _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        parents[i] = i;
+
+    struct __graph_boruvka boruvka = { graph, starts, ends, components, cheapest, pool->threads_amount };
+
+    int merged = 1;
+
+    while (merged)
+    {
+        merged = 0;
+
+        for (size_t i = 0; i < vertices_amount; i++)
+        {
+            components[i] = __graph_union_find(parents, i);
+            cheapest[i] = _GRAPH_NO_POSITION__;
+        }
+
+        __graph_pool_run(pool, __graph_boruvka_cheapest, &boruvka);
+
+        for (size_t i = 0; i < vertices_amount; i++)
+        {
+            size_t edge = cheapest[i];
+
+            if (edge != _GRAPH_NO_POSITION__ && __graph_union(parents, ranks, starts[edge], ends[edge]))
+            {
+                forest->edges[forest->edges_amount++] = edge;
+                forest->length += graph->edges[edge].length;
+                merged = 1;
+            }
+        }
+    }
+
+    free(parents);
+    free(components);
+    free(cheapest);
+    free(ranks);
+
+    return _GRAPH_OK__;
+}
+
+graph_error_t graph_mst(const struct graph *graph, int algorithm, size_t threads_amount, struct graph_spanning_forest *forest)
+{
+    if (!graph || !forest || algorithm < _GRAPH_MST_AUTO__ || algorithm > _GRAPH_MST_BORUVKA__)
+        return _GRAPH_INCORRECT_ARG__;
+
+    *forest = (struct graph_spanning_forest) {0};
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    if (algorithm == _GRAPH_MST_AUTO__)
+    {
+        if (graph->edges_amount / graph->vertices_amount >= _GRAPH_MST_DENSITY__)
+            algorithm = _GRAPH_MST_PRIM__;
+        else
+            algorithm = _GRAPH_MST_KRUSKAL__;
+    }
+
+    forest->edges = malloc(graph->vertices_amount * sizeof(size_t));
+    if (!forest->edges)
+        return _GRAPH_MEM__;
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (algorithm == _GRAPH_MST_PRIM__)
+        rc = __graph_mst_prim(graph, forest);
+    else
+    {
+        struct __graph_name *names = __graph_names_create(graph);
+        size_t *starts = malloc((graph->edges_amount + 1) * sizeof(size_t));
+        size_t *ends = malloc((graph->edges_amount + 1) * sizeof(size_t));
+
+        struct __graph_pool pool = {0};
+
+        if (!names || !starts || !ends)
+            rc = _GRAPH_MEM__;
+
+        if (rc == _GRAPH_OK__)
+        {
+            __graph_edges_resolve(graph, names, starts, ends);
+            rc = __graph_pool_create(&pool, __graph_threads_amount(threads_amount));
+        }
+
+        if (rc == _GRAPH_OK__)
+        {
+            if (algorithm == _GRAPH_MST_KRUSKAL__)
+                rc = __graph_mst_kruskal(graph, starts, ends, &pool, forest);
+            else
+                rc = __graph_mst_boruvka(graph, starts, ends, &pool, forest);
+
+            __graph_pool_free(&pool);
+        }
+
+        free(names);
+        free(starts);
+        free(ends);
+    }
+
+    if (rc != _GRAPH_OK__)
+        graph_spanning_forest_free(forest);
+
+    return rc;
+}
+
+void graph_spanning_forest_free(struct graph_spanning_forest *forest)
+{
+    if (forest)
+    {
+        free(forest->edges);
+        *forest = (struct graph_spanning_forest) {0};
+    }
+}
+
+// sparse matrix by vector multiplication and PageRank
+
+void graph_sparse_matrix_free(struct sparse_matrix *matrix)
+{
+    if (matrix)
+    {
+        free(matrix->row_offsets);
+        free(matrix->column_indexes);
+        free(matrix->values);
+    }
+
+    free(matrix);
+}
+
+static struct sparse_matrix *__graph_transition_matrix_create(const struct graph *graph, size_t *out_degrees)
+{
+    struct __graph_name *names = __graph_names_create(graph);
+    if (!names)
+        return NULL;
+
+    struct __graph_csr csr;
+
+    graph_error_t rc = __graph_csr_create(graph, names, _GRAPH_CSR_REVERSE__, &csr);
+
+    free(names);
+
+    if (rc != _GRAPH_OK__)
+        return NULL;
+
+    struct sparse_matrix *matrix = calloc(1, sizeof(struct sparse_matrix));
+    if (!matrix)
+    {
+        __graph_csr_free(&csr);
+        return NULL;
+    }
+
+    matrix->values = malloc((csr.edges_amount + 1) * sizeof(double));
+    if (!matrix->values)
+    {
+        __graph_csr_free(&csr);
+        free(matrix);
+
+        return NULL;
+    }
+
+    // the adjacency arrays are taken by the matrix
+
+    matrix->row_offsets = csr.offsets;
+    matrix->column_indexes = csr.targets;
+    matrix->rows = csr.vertices_amount;
+    matrix->columns = csr.vertices_amount;
+
+    free(csr.lengths);
+    free(csr.edges);
+
+    memset(out_degrees, 0, csr.vertices_amount * sizeof(size_t));
+
+    for (size_t i = 0; i < csr.edges_amount; i++)
+        out_degrees[matrix->column_indexes[i]]++;
+
+    for (size_t i = 0; i < csr.edges_amount; i++)
+        matrix->values[i] = 1.0 / out_degrees[matrix->column_indexes[i]];
+
+    return matrix;
+}
+
+struct sparse_matrix *graph_transition_matrix_create(const struct graph *graph)
+{
+    if (!graph)
+        return NULL;
+
+    size_t *out_degrees = malloc((graph->vertices_amount + 1) * sizeof(size_t));
+    if (!out_degrees)
+        return NULL;
+
+    struct sparse_matrix *matrix = __graph_transition_matrix_create(graph, out_degrees);
+
+    free(out_degrees);
+
+    return matrix;
+}
+
+static void __graph_sparse_matrix_rows_multiply(const struct sparse_matrix *matrix, const double *restrict vector, \
+    double *restrict result, size_t begin, size_t end)
+{
+    const size_t *restrict offsets = matrix->row_offsets;
+    const size_t *restrict columns = matrix->column_indexes;
+    const double *restrict values = matrix->values;
+
+    for (size_t row = begin; row < end; row++)
+    {
+        // independent partial sums let the compiler interleave the gathers
+
+        double sums[4] = {0};
+
+        size_t i = offsets[row];
+
+        for (; i + 4 <= offsets[row + 1]; i += 4)
+        {
+            sums[0] += values[i] * vector[columns[i]];
+            sums[1] += values[i + 1] * vector[columns[i + 1]];
+            sums[2] += values[i + 2] * vector[columns[i + 2]];
+            sums[3] += values[i + 3] * vector[columns[i + 3]];
+        }
+
+        for (; i < offsets[row + 1]; i++)
+            sums[0] += values[i] * vector[columns[i]];
+
+        result[row] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+}
+
+static void __graph_sparse_matrix_partition(const struct sparse_matrix *matrix, size_t parts_amount, size_t *bounds)
+{
+    size_t values_amount = matrix->row_offsets[matrix->rows];
+
+    bounds[0] = 0;
+
+    for (size_t part = 1; part < parts_amount; part++)
+    {
+        // first row starting not before the equal share of nonzero values
+
+        size_t target = values_amount * part / parts_amount;
+        size_t low = bounds[part - 1];
+        size_t high = matrix->rows;
+
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+
+            if (matrix->row_offsets[middle] < target)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        bounds[part] = low;
+    }
+
+    bounds[parts_amount] = matrix->rows;
+}
+
+struct __graph_sparse_multiplication
+{
+    const struct sparse_matrix *matrix;
+    const size_t *bounds;
+    const double *vector;
+    double *result;
+};
+
+static void __graph_sparse_matrix_multiply_task(void *context, size_t thread_index)
+{
+    struct __graph_sparse_multiplication *multiplication = context;
+
+    __graph_sparse_matrix_rows_multiply(multiplication->matrix, multiplication->vector, multiplication->result, \
+        multiplication->bounds[thread_index], multiplication->bounds[thread_index + 1]);
+}
+
+graph_error_t graph_sparse_matrix_multiply(const struct sparse_matrix *matrix, const double *vector, double *result, size_t threads_amount)
+{
+    if (!matrix || !vector || !result)
+        return _GRAPH_INCORRECT_ARG__;
+
+    // threads are started only for their share of nonzero values, small products stay on the calling thread
+
+    size_t values_amount = matrix->row_offsets[matrix->rows];
+
+    threads_amount = __graph_threads_amount(threads_amount);
+
+    if (threads_amount > values_amount / _GRAPH_SPARSE_THREAD_VALUES__)
+        threads_amount = values_amount / _GRAPH_SPARSE_THREAD_VALUES__;
+
+    if (threads_amount <= 1)
+    {
+        __graph_sparse_matrix_rows_multiply(matrix, vector, result, 0, matrix->rows);
+        return _GRAPH_OK__;
+    }
+
+    struct __graph_pool pool;
+
+    graph_error_t rc = __graph_pool_create(&pool, threads_amount);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t *bounds = malloc((pool.threads_amount + 1) * sizeof(size_t));
+
+    if (!bounds)
+        rc = _GRAPH_MEM__;
+    else
+    {
+        __graph_sparse_matrix_partition(matrix, pool.threads_amount, bounds);
+
+        struct __graph_sparse_multiplication multiplication = { matrix, bounds, vector, result };
+
+        __graph_pool_run(&pool, __graph_sparse_matrix_multiply_task, &multiplication);
+    }
+
+    free(bounds);
+    __graph_pool_free(&pool);
+
+    return rc;
+}
+
+struct __graph_pagerank
+{
+    struct __graph_sparse_multiplication multiplication;
+    double base;
+    double damping;
+    double *changes;
+};
+
+static void __graph_pagerank_task(void *context, size_t thread_index)
+{
+    struct __graph_pagerank *pagerank = context;
+
+    size_t begin = pagerank->multiplication.bounds[thread_index];
+    size_t end = pagerank->multiplication.bounds[thread_index + 1];
+
+    const double *ranks = pagerank->multiplication.vector;
+    double *new_ranks = pagerank->multiplication.result;
+
+    __graph_sparse_matrix_rows_multiply(pagerank->multiplication.matrix, ranks, new_ranks, begin, end);
+
+    double change = 0;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        new_ranks[i] = pagerank->base + pagerank->damping * new_ranks[i];
+        change += new_ranks[i] > ranks[i] ? new_ranks[i] - ranks[i] : ranks[i] - new_ranks[i];
+    }
+
+    pagerank->changes[thread_index] = change;
+}
+
+graph_error_t graph_pagerank(const struct graph *graph, double damping, double tolerance, size_t max_iterations, \
+    size_t threads_amount, double *ranks)
+{
+    if (!graph || !ranks || !(damping >= 0 && damping <= 1) || !(tolerance >= 0))
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    size_t vertices_amount = graph->vertices_amount;
+
+    size_t *out_degrees = malloc(vertices_amount * sizeof(size_t));
+    double *new_ranks = malloc(vertices_amount * sizeof(double));
+
+    struct sparse_matrix *matrix = NULL;
+    size_t *bounds = NULL;
+    double *changes = NULL;
+
+    struct __graph_pool pool = {0};
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (!out_degrees || !new_ranks)
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+    {
+        matrix = __graph_transition_matrix_create(graph, out_degrees);
+        if (!matrix)
+            rc = _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_pool_create(&pool, __graph_threads_amount(threads_amount));
+
+    if (rc == _GRAPH_OK__)
+    {
+        bounds = malloc((pool.threads_amount + 1) * sizeof(size_t));
+        changes = malloc(pool.threads_amount * sizeof(double));
+
+        if (!bounds || !changes)
+            rc = _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        __graph_sparse_matrix_partition(matrix, pool.threads_amount, bounds);
+
+        for (size_t i = 0; i < vertices_amount; i++)
+            ranks[i] = 1.0 / vertices_amount;
+
+        struct __graph_pagerank pagerank = { { matrix, bounds, ranks, new_ranks }, 0, damping, changes };
+
+        for (size_t iteration = 0; iteration < max_iterations; iteration++)
+        {
+            // ranks of vertices without out-edges are spread evenly
+
+            double dangling = 0;
+
+            for (size_t i = 0; i < vertices_amount; i++)
+            {
+                if (!out_degrees[i])
+                    dangling += pagerank.multiplication.vector[i];
+            }
+
+            pagerank.base = (1 - damping + damping * dangling) / vertices_amount;
+
+            __graph_pool_run(&pool, __graph_pagerank_task, &pagerank);
+
+            double change = 0;
+
+            for (size_t i = 0; i < pool.threads_amount; i++)
+                change += changes[i];
+
+            double *tmp = (double *) pagerank.multiplication.vector;
+            pagerank.multiplication.vector = pagerank.multiplication.result;
+            pagerank.multiplication.result = tmp;
+
+            if (change < tolerance)
+                break;
+        }
+
+        if (pagerank.multiplication.vector != ranks)
+            memcpy(ranks, pagerank.multiplication.vector, vertices_amount * sizeof(double));
+    }
+
+    __graph_pool_free(&pool);
+    graph_sparse_matrix_free(matrix);
+
+    free(changes);
+    free(bounds);
+    free(new_ranks);
+    free(out_degrees);
+
+    return rc;
+}
+
+// betweenness centrality
+
+/**
+ * Buffers of a thread: state of the current source and accumulated centrality
+*/
+struct __graph_brandes_thread
+{
+    size_t *distances;
+    size_t *ranks;
+    size_t *order;
+    double *paths;
+    double *dependencies;
+    double *centrality;
+    struct __graph_heap heap;
+    struct __graph_brandes_rank *ties;
+};
+
+/**
+ * Vertex settled at the same distance as others, ordered by its rank among edges of zero length
+*/
+struct __graph_brandes_rank
+{
+    size_t rank;
+    size_t vertex;
+};
+
+struct __graph_brandes
+{
+    const struct __graph_csr *csr;
+    const size_t *zero_ranks;
+    const size_t *sources;
+    size_t sources_amount;
+    size_t next_source;
+    int weighted;
+    struct __graph_brandes_thread *threads;
+};
+
+static int __graph_brandes_rank_compare(const void *first, const void *second)
+{
+    size_t first_rank = ((const struct __graph_brandes_rank *) first)->rank;
+    size_t second_rank = ((const struct __graph_brandes_rank *) second)->rank;
+
+    return (first_rank > second_rank) - (first_rank < second_rank);
+}
+
+static void __graph_brandes_thread_free(struct __graph_brandes_thread *thread)
+{
+    free(thread->distances);
+    free(thread->ranks);
+    free(thread->order);
+    free(thread->paths);
+    free(thread->dependencies);
+    free(thread->centrality);
+    free(thread->ties);
+
+    __graph_heap_free(&thread->heap);
+}
+
+static graph_error_t __graph_brandes_thread_create(struct __graph_brandes_thread *thread, size_t vertices_amount, \
+    int weighted, int zero_lengths, double *centrality)
+{
+    *thread = (struct __graph_brandes_thread) {0};
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    thread->distances = malloc((vertices_amount + 1) * sizeof(size_t));
+    thread->ranks = malloc((vertices_amount + 1) * sizeof(size_t));
+    thread->order = malloc((vertices_amount + 1) * sizeof(size_t));
+    thread->paths = calloc(vertices_amount + 1, sizeof(double));
+    thread->dependencies = calloc(vertices_amount + 1, sizeof(double));
+    thread->centrality = centrality ? NULL : calloc(vertices_amount + 1, sizeof(double));
+
+    if (!thread->distances || !thread->ranks || !thread->order || !thread->paths || !thread->dependencies \
+        || (!centrality && !thread->centrality))
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__ && weighted)
+        rc = __graph_heap_create(&thread->heap, vertices_amount);
+
+    if (rc == _GRAPH_OK__ && zero_lengths)
+    {
+        thread->ties = malloc((vertices_amount + 1) * sizeof(struct __graph_brandes_rank));
+        if (!thread->ties)
+            rc = _GRAPH_MEM__;
+    }
+
+    if (rc != _GRAPH_OK__)
+    {
+        __graph_brandes_thread_free(thread);
+        return rc;
+    }
+
+    // the first thread accumulates straight into the result
+
+    if (centrality)
+        thread->centrality = centrality;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+    {
+        thread->distances[i] = _GRAPH_INFINITY__;
+        thread->ranks[i] = _GRAPH_NO_POSITION__;
+    }
+
+    return _GRAPH_OK__;
+}
+
+static size_t __graph_brandes_bfs(const struct __graph_csr *csr, struct __graph_brandes_thread *thread, size_t source)
+{
+    size_t *distances = thread->distances;
+    size_t *order = thread->order;
+    double *paths = thread->paths;
+
+    size_t head = 0;
+    size_t tail = 0;
+
+    distances[source] = 0;
+    paths[source] = 1;
+    thread->ranks[source] = tail;
+    order[tail++] = source;
+
+    while (head < tail)
+    {
+        size_t vertex = order[head++];
+        size_t distance = distances[vertex] + 1;
+
+        for (size_t i = csr->offsets[vertex]; i < csr->offsets[vertex + 1]; i++)
+        {
+            size_t target = csr->targets[i];
+
+            if (distances[target] == _GRAPH_INFINITY__)
+            {
+                distances[target] = distance;
+                thread->ranks[target] = tail;
+                order[tail++] = target;
+            }
+
+            if (distances[target] == distance)
+                paths[target] += paths[vertex];
+        }
+    }
+
+    return tail;
+}
+
+static size_t __graph_brandes_dijkstra(const struct __graph_csr *csr, const size_t *zero_ranks, \
+    struct __graph_brandes_thread *thread, size_t source)
+{
+    size_t *distances = thread->distances;
+    size_t *ranks = thread->ranks;
+    size_t *order = thread->order;
+    double *paths = thread->paths;
+
+    size_t settled = 0;
+
+    distances[source] = 0;
+    paths[source] = 1;
+    __graph_heap_push(&thread->heap, source, 0);
+
+    while (thread->heap.size)
+    {
+        size_t vertex = __graph_heap_pop(&thread->heap);
+        size_t distance = distances[vertex];
+
+        ranks[vertex] = settled;
+        order[settled++] = vertex;
+
+        for (size_t i = csr->offsets[vertex]; i < csr->offsets[vertex + 1]; i++)
+        {
+            size_t target = csr->targets[i];
+
+            if (ranks[target] != _GRAPH_NO_POSITION__ || csr->lengths[i] >= _GRAPH_INFINITY__ - distance)
+                continue;
+
+            size_t new_distance = distance + csr->lengths[i];
+
+            if (new_distance < distances[target])
+            {
+                distances[target] = new_distance;
+                paths[target] = paths[vertex];
+                __graph_heap_push(&thread->heap, target, new_distance);
+            }
+            else if (new_distance == distances[target])
+                paths[target] += paths[vertex];
+        }
+    }
+
+    // amounts of paths are exact for positive lengths only
+
+    if (!zero_ranks)
+        return settled;
+
+    // vertices at equal distance are settled in heap order, zero-length edges between them need a topological one
+
+    for (size_t begin = 0, end = 0; begin < settled; begin = end)
+    {
+        for (end = begin + 1; end < settled && distances[order[end]] == distances[order[begin]]; end++)
+            ;
+
+        if (end - begin == 1)
+            continue;
+
+        for (size_t i = begin; i < end; i++)
+            thread->ties[i - begin] = (struct __graph_brandes_rank) { zero_ranks[order[i]], order[i] };
+
+        qsort(thread->ties, end - begin, sizeof(struct __graph_brandes_rank), __graph_brandes_rank_compare);
+
+        for (size_t i = begin; i < end; i++)
+        {
+            order[i] = thread->ties[i - begin].vertex;
+            ranks[order[i]] = i;
+        }
+    }
+
+    // amounts of shortest paths are pushed again along tight edges in the topological order
+
+    for (size_t i = 1; i < settled; i++)
+        paths[order[i]] = 0;
+
+    for (size_t i = 0; i < settled; i++)
+    {
+        size_t vertex = order[i];
+
+        for (size_t j = csr->offsets[vertex]; j < csr->offsets[vertex + 1]; j++)
+        {
+            size_t target = csr->targets[j];
+
+            if (ranks[target] != _GRAPH_NO_POSITION__ && ranks[target] > i \
+                && distances[target] - distances[vertex] == csr->lengths[j])
+                paths[target] += paths[vertex];
+        }
+    }
+
+    return settled;
+}
+
+/**
+ * Topological ranks of vertices among edges of zero length (loops are never on shortest paths)
+*/
+static graph_error_t __graph_brandes_zero_ranks(const struct __graph_csr *csr, size_t *zero_ranks)
+{
+    size_t vertices_amount = csr->vertices_amount;
+
+    size_t *degrees = calloc(vertices_amount + 1, sizeof(size_t));
+    size_t *queue = malloc((vertices_amount + 1) * sizeof(size_t));
+
+    if (!degrees || !queue)
+    {
+        free(degrees);
+        free(queue);
+        return _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        for (size_t j = csr->offsets[i]; j < csr->offsets[i + 1]; j++)
+            if (!csr->lengths[j] && csr->targets[j] != i)
+                degrees[csr->targets[j]]++;
+
+    size_t head = 0;
+    size_t tail = 0;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        if (!degrees[i])
+            queue[tail++] = i;
+
+    while (head < tail)
+    {
+        size_t vertex = queue[head];
+        zero_ranks[vertex] = head++;
+
+        for (size_t j = csr->offsets[vertex]; j < csr->offsets[vertex + 1]; j++)
+            if (!csr->lengths[j] && csr->targets[j] != vertex && !--degrees[csr->targets[j]])
+                queue[tail++] = csr->targets[j];
+    }
+
+    free(degrees);
+    free(queue);
+
+    // a cycle of zero length gives infinitely many shortest paths
+
+    return tail == vertices_amount ? _GRAPH_OK__ : _GRAPH_INCORRECT_ARG__;
+}
+
+static void __graph_brandes_task(void *context, size_t thread_index)
+{
+    struct __graph_brandes *brandes = context;
+    struct __graph_brandes_thread *thread = brandes->threads + thread_index;
+    const struct __graph_csr *csr = brandes->csr;
+
+    for (;;)
+    {
+        size_t next = __atomic_fetch_add(&brandes->next_source, 1, __ATOMIC_RELAXED);
+        if (next >= brandes->sources_amount)
+            break;
+
+        size_t source = brandes->sources ? brandes->sources[next] : next;
+
+        size_t settled = brandes->weighted ? __graph_brandes_dijkstra(csr, brandes->zero_ranks, thread, source) \
+            : __graph_brandes_bfs(csr, thread, source);
+
+        // accumulating dependencies from the farthest vertices back to the source
+
+        for (size_t i = settled; i-- > 0;)
+        {
+            size_t vertex = thread->order[i];
+            size_t distance = thread->distances[vertex];
+            double dependency = 0;
+
+            for (size_t j = csr->offsets[vertex]; j < csr->offsets[vertex + 1]; j++)
+            {
+                size_t target = csr->targets[j];
+                size_t length = brandes->weighted ? csr->lengths[j] : 1;
+
+                if (thread->ranks[target] != _GRAPH_NO_POSITION__ && thread->ranks[target] > i \
+                    && thread->distances[target] - distance == length)
+                    dependency += (1 + thread->dependencies[target]) / thread->paths[target];
+            }
+
+            thread->dependencies[vertex] = thread->paths[vertex] * dependency;
+
+            if (vertex != source)
+                thread->centrality[vertex] += thread->dependencies[vertex];
+        }
+
+        for (size_t i = 0; i < settled; i++)
+        {
+            size_t vertex = thread->order[i];
+
+            thread->distances[vertex] = _GRAPH_INFINITY__;
+            thread->ranks[vertex] = _GRAPH_NO_POSITION__;
+            thread->paths[vertex] = 0;
+            thread->dependencies[vertex] = 0;
+        }
+    }
+}
+
+static void __graph_brandes_sample(size_t *sources, size_t vertices_amount, size_t samples_amount)
+{
+    uint64_t state = _GRAPH_BETWEENNESS_SEED__;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        sources[i] = i;
+
+    // partial Fisher-Yates shuffle driven by xorshift
+
+    for (size_t i = 0; i < samples_amount; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        size_t j = i + (size_t) (state % (vertices_amount - i));
+
+        size_t tmp = sources[i];
+        sources[i] = sources[j];
+        sources[j] = tmp;
+    }
+}
+
+graph_error_t graph_betweenness(const struct graph *graph, size_t samples_amount, size_t threads_amount, double *centrality)
+{
+    if (!graph || !centrality)
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    size_t vertices_amount = graph->vertices_amount;
+
+    if (!samples_amount || samples_amount > vertices_amount)
+        samples_amount = vertices_amount;
+
+    struct __graph_csr csr = {0};
+    struct __graph_pool pool = {0};
+    struct __graph_brandes_thread *threads = NULL;
+    size_t *sources = NULL;
+    size_t *zero_ranks = NULL;
+    size_t threads_created = 0;
+
+    struct __graph_name *names = __graph_names_create(graph);
+
+    graph_error_t rc = names ? __graph_csr_create(graph, names, _GRAPH_CSR_FORWARD__, &csr) : _GRAPH_MEM__;
+
+    free(names);
+
+    // equal nonzero lengths give the same shortest paths as hops
+
+    int weighted = 0;
+
+    for (size_t i = 1; rc == _GRAPH_OK__ && i < csr.edges_amount && !weighted; i++)
+        weighted = csr.lengths[i] != csr.lengths[0];
+
+    if (rc == _GRAPH_OK__ && csr.edges_amount)
+        weighted = weighted || !csr.lengths[0];
+
+    int zero_lengths = 0;
+
+    for (size_t i = 0; rc == _GRAPH_OK__ && i < csr.edges_amount && !zero_lengths; i++)
+        zero_lengths = !csr.lengths[i];
+
+    if (rc == _GRAPH_OK__ && zero_lengths)
+    {
+        zero_ranks = malloc(vertices_amount * sizeof(size_t));
+        rc = zero_ranks ? __graph_brandes_zero_ranks(&csr, zero_ranks) : _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__ && samples_amount < vertices_amount)
+    {
+        sources = malloc(vertices_amount * sizeof(size_t));
+
+        if (sources)
+            __graph_brandes_sample(sources, vertices_amount, samples_amount);
+        else
+            rc = _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_pool_create(&pool, __graph_threads_amount(threads_amount));
+
+    if (rc == _GRAPH_OK__)
+    {
+        threads = malloc(pool.threads_amount * sizeof(struct __graph_brandes_thread));
+        if (!threads)
+            rc = _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i < vertices_amount; i++)
+            centrality[i] = 0;
+    }
+
+    for (; rc == _GRAPH_OK__ && threads_created < pool.threads_amount; threads_created++)
+    {
+        rc = __graph_brandes_thread_create(threads + threads_created, vertices_amount, weighted, zero_lengths, \
+            threads_created ? NULL : centrality);
+
+        if (rc != _GRAPH_OK__)
+            break;
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        struct __graph_brandes brandes = { &csr, zero_ranks, sources, samples_amount, 0, weighted, threads };
+
+        __graph_pool_run(&pool, __graph_brandes_task, &brandes);
+
+        // merging accumulators of threads and extrapolating sampled sources
+
+        for (size_t t = 1; t < pool.threads_amount; t++)
+            for (size_t i = 0; i < vertices_amount; i++)
+                centrality[i] += threads[t].centrality[i];
+
+        double scale = (double) vertices_amount / (double) samples_amount;
+
+        if (graph->mode == _GRAPH_UNDIRECTED__)
+            scale /= 2;
+
+        for (size_t i = 0; i < vertices_amount; i++)
+            centrality[i] *= scale;
+    }
+
+    for (size_t t = 0; t < threads_created; t++)
+    {
+        if (!t)
+            threads[t].centrality = NULL;
+
+        __graph_brandes_thread_free(threads + t);
+    }
+
+    __graph_pool_free(&pool);
+    __graph_csr_free(&csr);
+
+    free(threads);
+    free(sources);
+    free(zero_ranks);
+
+    return rc;
+}
+
+// vertices reordering
+
+/**
+ * Stable counting sort of vertices by degree in the compressed adjacency with edges of both directions
+*/
+static graph_error_t __graph_reorder_by_degree(const struct __graph_csr *csr, int descending, size_t *order)
+{
+    size_t vertices_amount = csr->vertices_amount;
+    size_t max_degree = 0;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+    {
+        size_t degree = csr->offsets[i + 1] - csr->offsets[i];
+        if (degree > max_degree)
+            max_degree = degree;
+    }
+
+    size_t *counts = calloc(max_degree + 2, sizeof(size_t));
+    if (!counts)
+        return _GRAPH_MEM__;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+    {
+        size_t degree = csr->offsets[i + 1] - csr->offsets[i];
+        counts[(descending ? max_degree - degree : degree) + 1]++;
+    }
+
+    for (size_t i = 0; i <= max_degree; i++)
+        counts[i + 1] += counts[i];
+
+    for (size_t i = 0; i < vertices_amount; i++)
+    {
+        size_t degree = csr->offsets[i + 1] - csr->offsets[i];
+        order[counts[descending ? max_degree - degree : degree]++] = i;
+    }
+
+    free(counts);
+
+    return _GRAPH_OK__;
+}
+
+/**
+ * Breadth-first order of all components, starting each one from the first unvisited vertex of `starts`
+*/
+static void __graph_reorder_bfs(const struct __graph_csr *csr, const size_t *targets, const size_t *starts, \
+    char *visited, size_t *order)
+{
+    size_t tail = 0;
+
+    for (size_t i = 0; i < csr->vertices_amount; i++)
+    {
+        if (visited[starts[i]])
+            continue;
+
+        size_t head = tail;
+
+        visited[starts[i]] = 1;
+        order[tail++] = starts[i];
+
+        while (head < tail)
+        {
+            size_t vertex = order[head++];
+
+            for (size_t j = csr->offsets[vertex]; j < csr->offsets[vertex + 1]; j++)
+            {
+                if (!visited[targets[j]])
+                {
+                    visited[targets[j]] = 1;
+                    order[tail++] = targets[j];
+                }
+            }
+        }
+    }
+}
+
+static graph_error_t __graph_reorder_order(const struct __graph_csr *csr, int strategy, size_t *order)
+{
+    size_t vertices_amount = csr->vertices_amount;
+
+    if (strategy == _GRAPH_REORDER_DEGREE__)
+        return __graph_reorder_by_degree(csr, 1, order);
+
+    size_t *starts = malloc((vertices_amount + 1) * sizeof(size_t));
+    char *visited = calloc(vertices_amount + 1, sizeof(char));
+    size_t *targets = NULL;
+
+    graph_error_t rc = starts && visited ? _GRAPH_OK__ : _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__ && strategy == _GRAPH_REORDER_BFS__)
+    {
+        for (size_t i = 0; i < vertices_amount; i++)
+            starts[i] = i;
+
+        __graph_reorder_bfs(csr, csr->targets, starts, visited, order);
+    }
+
+    // Cuthill-McKee starts components from vertices of minimum degree and visits neighbours by increasing degree
+
+    if (rc == _GRAPH_OK__ && strategy == _GRAPH_REORDER_RCM__)
+        rc = __graph_reorder_by_degree(csr, 0, starts);
+
+    if (rc == _GRAPH_OK__ && strategy == _GRAPH_REORDER_RCM__)
+    {
+        targets = calloc(csr->edges_amount + 1, sizeof(size_t));
+        size_t *cursors = malloc((vertices_amount + 1) * sizeof(size_t));
+
+        if (!targets || !cursors)
+            rc = _GRAPH_MEM__;
+
+        // adjacency is symmetric, so appending every vertex in increasing degree to the rows of its neighbours sorts them
+
+        if (rc == _GRAPH_OK__)
+        {
+            memcpy(cursors, csr->offsets, vertices_amount * sizeof(size_t));
+
+            for (size_t i = 0; i < vertices_amount; i++)
+            {
+                size_t vertex = starts[i];
+
+                for (size_t j = csr->offsets[vertex]; j < csr->offsets[vertex + 1]; j++)
+                    targets[cursors[csr->targets[j]]++] = vertex;
+            }
+
+            __graph_reorder_bfs(csr, targets, starts, visited, order);
+
+            for (size_t i = 0; i < vertices_amount / 2; i++)
+            {
+                size_t tmp = order[i];
+                order[i] = order[vertices_amount - 1 - i];
+                order[vertices_amount - 1 - i] = tmp;
+            }
+        }
+
+        free(cursors);
+    }
+
+    free(targets);
+    free(visited);
+    free(starts);
+
+    return rc;
+}
+
+static void __graph_reorder_edges_sort(const size_t *vertices, const size_t *positions, size_t vertices_amount, \
+    size_t edges_amount, const size_t *from, size_t *to, size_t *counts)
+{
+    memset(counts, 0, (vertices_amount + 2) * sizeof(size_t));
+
+    for (size_t i = 0; i < edges_amount; i++)
+        counts[positions[vertices[i]] + 1]++;
+
+    for (size_t i = 0; i <= vertices_amount; i++)
+        counts[i + 1] += counts[i];
+
+    for (size_t i = 0; i < edges_amount; i++)
+    {
+        size_t edge = from ? from[i] : i;
+        to[counts[positions[vertices[edge]]]++] = edge;
+    }
+}
+
+graph_error_t graph_reorder(struct graph *graph, int strategy, size_t *permutation)
+{
+    if (!graph || (strategy != _GRAPH_REORDER_RCM__ && strategy != _GRAPH_REORDER_DEGREE__ \
+        && strategy != _GRAPH_REORDER_BFS__))
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    size_t vertices_amount = graph->vertices_amount;
+    size_t edges_amount = graph->edges_amount;
+
+    struct __graph_csr csr = {0};
+
+    struct __graph_name *names = __graph_names_create(graph);
+    size_t *order = malloc((vertices_amount + 1) * sizeof(size_t));
+    size_t *positions = malloc((vertices_amount + 1) * sizeof(size_t));
+    size_t *counts = malloc((vertices_amount + 2) * sizeof(size_t));
+    size_t *starts = malloc((edges_amount + 1) * sizeof(size_t));
+    size_t *ends = malloc((edges_amount + 1) * sizeof(size_t));
+    size_t *sorted = malloc((edges_amount + 1) * sizeof(size_t));
+    size_t *buffer = malloc((edges_amount + 1) * sizeof(size_t));
+    char **vertices = malloc((vertices_amount + 1) * sizeof(char *));
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (!names || !order || !positions || !counts || !starts || !ends || !sorted || !buffer || !vertices)
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+    {
+        __graph_edges_resolve(graph, names, starts, ends);
+        rc = __graph_csr_resolved_create(graph, starts, ends, _GRAPH_CSR_BOTH__, &csr);
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_reorder_order(&csr, strategy, order);
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i < vertices_amount; i++)
+        {
+            positions[order[i]] = i;
+            vertices[i] = graph->vertices[order[i]];
+        }
+
+        // edges with unknown vertices are kept at the end
+
+        positions[vertices_amount] = vertices_amount;
+
+        // two passes of counting sort arrange edges by new indexes of start and then end vertices
+
+        __graph_reorder_edges_sort(ends, positions, vertices_amount, edges_amount, NULL, buffer, counts);
+        __graph_reorder_edges_sort(starts, positions, vertices_amount, edges_amount, buffer, sorted, counts);
+
+        // edges are moved in place along the cycles of the permutation, marking placed ones
+
+        for (size_t i = 0; i < edges_amount; i++)
+        {
+            if (sorted[i] == i)
+                continue;
+
+            struct edge edge = graph->edges[i];
+            size_t position = i;
+
+            while (sorted[position] != i)
+            {
+                size_t next = sorted[position];
+
+                graph->edges[position] = graph->edges[next];
+                sorted[position] = position;
+                position = next;
+            }
+
+            graph->edges[position] = edge;
+            sorted[position] = position;
+        }
+
+        free(graph->vertices);
+
+        graph->vertices = vertices;
+        vertices = NULL;
+
+        if (permutation)
+            memcpy(permutation, positions, vertices_amount * sizeof(size_t));
+
+        // cached adjacencies, distances and workspaces are rebuilt in the new order
+
+        __graph_touch(graph);
+    }
+
+    __graph_csr_free(&csr);
+
+    free(vertices);
+    free(buffer);
+    free(sorted);
+    free(ends);
+    free(starts);
+    free(counts);
+    free(positions);
+    free(order);
+    free(names);
+
+    return rc;
+}
+
+// compressed adjacency
+
+static inline unsigned char *__graph_varint_encode(unsigned char *position, size_t value)
+{
+    while (value >= 0x80)
+    {
+        *position++ = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+
+    *position++ = (unsigned char) value;
+
+    return position;
+}
+
+static inline const unsigned char *__graph_varint_decode(const unsigned char *position, size_t *value)
+{
+    size_t result = *position & 0x7F;
+
+    for (unsigned shift = 7; *position++ & 0x80; shift += 7)
+        result |= (size_t) (*position & 0x7F) << shift;
+
+    *value = result;
+
+    return position;
+}
+
+struct graph_compressed *graph_compressed_create(size_t vertices_amount)
+{
+    struct graph_compressed *compressed = calloc(1, sizeof(struct graph_compressed));
+    if (!compressed)
+        return NULL;
+
+    // all vertices share the empty neighbour list at position zero until they are appended
+
+    compressed->vertices_amount = vertices_amount;
+    compressed->offsets = calloc(vertices_amount + 1, sizeof(size_t));
+    compressed->skip_starts = calloc(vertices_amount + 1, sizeof(size_t));
+    compressed->data = calloc(1, sizeof(unsigned char));
+    compressed->data_size = 1;
+    compressed->data_capacity = 1;
+
+    if (!compressed->offsets || !compressed->skip_starts || !compressed->data)
+    {
+        graph_compressed_free(compressed);
+        return NULL;
+    }
+
+    return compressed;
+}
+
+graph_error_t graph_compressed_append(struct graph_compressed *compressed, size_t vertex, const size_t *neighbours, \
+    const size_t *lengths, size_t neighbours_amount)
+{
+    if (!compressed || vertex < compressed->appended || vertex >= compressed->vertices_amount \
+        || (neighbours_amount && (!neighbours || !lengths)))
+        return _GRAPH_INCORRECT_ARG__;
+
+    for (size_t i = 0; i < neighbours_amount; i++)
+    {
+        if (neighbours[i] >= compressed->vertices_amount || (i && neighbours[i] <= neighbours[i - 1]))
+            return _GRAPH_INCORRECT_ARG__;
+    }
+
+    // reserving the worst case size of the list and of its samples
+
+    size_t required = compressed->data_size + (2 * neighbours_amount + 1) * _GRAPH_VARINT_MAX__;
+
+    if (required > compressed->data_capacity)
+    {
+        size_t capacity = 2 * compressed->data_capacity > required ? 2 * compressed->data_capacity : required;
+
+        unsigned char *tmp = realloc(compressed->data, capacity);
+        if (!tmp)
+            return _GRAPH_MEM__;
+
+        compressed->data = tmp;
+        compressed->data_capacity = capacity;
+    }
+
+    size_t required_skips = compressed->skips_amount + neighbours_amount / _GRAPH_SKIP_INTERVAL__;
+
+    if (required_skips > compressed->skips_capacity)
+    {
+        size_t capacity = 2 * compressed->skips_capacity > required_skips ? 2 * compressed->skips_capacity : required_skips;
+
+        size_t (*tmp)[2] = realloc(compressed->skips, capacity * sizeof(size_t [2]));
+        if (!tmp)
+            return _GRAPH_MEM__;
+
+        compressed->skips = tmp;
+        compressed->skips_capacity = capacity;
+    }
+
+    compressed->offsets[vertex] = compressed->data_size;
+    compressed->skip_starts[vertex] = compressed->skips_amount;
+
+    unsigned char *position = __graph_varint_encode(compressed->data + compressed->data_size, neighbours_amount);
+
+    for (size_t i = 0; i < neighbours_amount; i++)
+    {
+        position = __graph_varint_encode(position, i ? neighbours[i] - neighbours[i - 1] - 1 : neighbours[i]);
+        position = __graph_varint_encode(position, lengths[i]);
+
+        if ((i + 1) % _GRAPH_SKIP_INTERVAL__ == 0)
+        {
+            compressed->skips[compressed->skips_amount][0] = neighbours[i];
+            compressed->skips[compressed->skips_amount][1] = position - compressed->data;
+            compressed->skips_amount++;
+        }
+    }
+
+    compressed->data_size = position - compressed->data;
+    compressed->edges_amount += neighbours_amount;
+    compressed->appended = vertex + 1;
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_csr_sorted_create(const struct graph *graph, struct __graph_csr *csr)
+{
+    struct __graph_name *names = __graph_names_create(graph);
+    if (!names)
+        return _GRAPH_MEM__;
+
+    // adjacency by end vertices turned into start vertices lists sorted by end vertices
+
+    struct __graph_csr reverse;
+    graph_error_t rc = __graph_csr_create(graph, names, _GRAPH_CSR_REVERSE__, &reverse);
+
+    free(names);
+
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t vertices_amount = graph->vertices_amount;
+
+    *csr = (struct __graph_csr) {0};
+    csr->vertices_amount = vertices_amount;
+    csr->edges_amount = reverse.edges_amount;
+    csr->offsets = calloc(vertices_amount + 1, sizeof(size_t));
+    csr->targets = malloc((reverse.edges_amount + 1) * sizeof(size_t));
+    csr->lengths = malloc((reverse.edges_amount + 1) * sizeof(size_t));
+    csr->edges = malloc((reverse.edges_amount + 1) * sizeof(size_t));
+
+    if (!csr->offsets || !csr->targets || !csr->lengths || !csr->edges)
+    {
+        __graph_csr_free(csr);
+        __graph_csr_free(&reverse);
+
+        return _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < reverse.edges_amount; i++)
+        csr->offsets[reverse.targets[i] + 1]++;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        csr->offsets[i + 1] += csr->offsets[i];
+
+    for (size_t end = 0; end < vertices_amount; end++)
+    {
+        for (size_t i = reverse.offsets[end]; i < reverse.offsets[end + 1]; i++)
+        {
+            size_t position = csr->offsets[reverse.targets[i]]++;
+
+            csr->targets[position] = end;
+            csr->lengths[position] = reverse.lengths[i];
+            csr->edges[position] = reverse.edges[i];
+        }
+    }
+
+    for (size_t i = vertices_amount; i > 0; i--)
+        csr->offsets[i] = csr->offsets[i - 1];
+    csr->offsets[0] = 0;
+
+    __graph_csr_free(&reverse);
+
+    return _GRAPH_OK__;
+}
+
+struct graph_compressed *graph_compressed_from_graph(const struct graph *graph)
+{
+    if (!graph)
+        return NULL;
+
+    struct __graph_csr csr;
+
+    if (__graph_csr_sorted_create(graph, &csr) != _GRAPH_OK__)
+        return NULL;
+
+    struct graph_compressed *compressed = graph_compressed_create(csr.vertices_amount);
+
+    for (size_t i = 0; i < csr.vertices_amount && compressed; i++)
+    {
+        size_t begin = csr.offsets[i];
+
+        if (graph_compressed_append(compressed, i, csr.targets + begin, csr.lengths + begin, csr.offsets[i + 1] - begin) != _GRAPH_OK__)
+        {
+            graph_compressed_free(compressed);
+            compressed = NULL;
+        }
+    }
+
+    __graph_csr_free(&csr);
+
+    return compressed;
+}
+
+void graph_compressed_iterator_init(const struct graph_compressed *compressed, size_t vertex, struct graph_compressed_iterator *iterator)
+{
+    if (!iterator)
+        return;
+
+    *iterator = (struct graph_compressed_iterator) {0};
+
+    if (compressed && vertex < compressed->vertices_amount)
+        iterator->position = __graph_varint_decode(compressed->data + compressed->offsets[vertex], &iterator->remaining);
+}
+
+int graph_compressed_iterator_next(struct graph_compressed_iterator *iterator, size_t *neighbour, size_t *length)
+{
+    if (!iterator || !iterator->remaining || !neighbour)
+        return 0;
+
+    size_t gap = 0;
+    size_t edge_length = 0;
+
+    iterator->position = __graph_varint_decode(iterator->position, &gap);
+    iterator->position = __graph_varint_decode(iterator->position, &edge_length);
+
+    iterator->neighbour = iterator->started ? iterator->neighbour + gap + 1 : gap;
+    iterator->started = 1;
+    iterator->remaining--;
+
+    *neighbour = iterator->neighbour;
+
+    if (length)
+        *length = edge_length;
+
+    return 1;
+}
+
+int graph_compressed_has_edge(const struct graph_compressed *compressed, size_t start_vertex, size_t end_vertex)
+{
+    if (!compressed || start_vertex >= compressed->vertices_amount || end_vertex >= compressed->vertices_amount)
+        return 0;
+
+    struct graph_compressed_iterator iterator;
+
+    graph_compressed_iterator_init(compressed, start_vertex, &iterator);
+
+    // the last sample not greater than the searched neighbour
+
+    size_t (*skips)[2] = compressed->skips + compressed->skip_starts[start_vertex];
+    size_t skips_amount = iterator.remaining / _GRAPH_SKIP_INTERVAL__;
+
+    size_t low = 0;
+    size_t high = skips_amount;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (skips[middle][0] <= end_vertex)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if (low)
+    {
+        if (skips[low - 1][0] == end_vertex)
+            return 1;
+
+        iterator.position = compressed->data + skips[low - 1][1];
+        iterator.remaining -= low * _GRAPH_SKIP_INTERVAL__;
+        iterator.neighbour = skips[low - 1][0];
+        iterator.started = 1;
+    }
+
+    size_t neighbour = 0;
+
+    while (graph_compressed_iterator_next(&iterator, &neighbour, NULL) && neighbour <= end_vertex)
+    {
+        if (neighbour == end_vertex)
+            return 1;
+    }
+
+    return 0;
+}
+
+graph_error_t graph_compressed_bfs(const struct graph_compressed *compressed, size_t source, \
+    void (*vertex_processing)(size_t vertex, void *context), void *context)
+{
+    if (!compressed || !vertex_processing || source >= compressed->vertices_amount)
+        return _GRAPH_INCORRECT_ARG__;
+
+    size_t *queue = malloc(compressed->vertices_amount * sizeof(size_t));
+    unsigned char *visited = calloc(compressed->vertices_amount, sizeof(unsigned char));
+
+    if (!queue || !visited)
+    {
+        free(queue);
+        free(visited);
+
+        return _GRAPH_MEM__;
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+
+    queue[tail++] = source;
+    visited[source] = 1;
+
+    while (head < tail)
+    {
+        size_t vertex = queue[head++];
+
+        vertex_processing(vertex, context);
+
+        struct graph_compressed_iterator iterator;
+        size_t neighbour = 0;
+
+        graph_compressed_iterator_init(compressed, vertex, &iterator);
+
+        while (graph_compressed_iterator_next(&iterator, &neighbour, NULL))
+        {
+            if (!visited[neighbour])
+            {
+                visited[neighbour] = 1;
+                queue[tail++] = neighbour;
+            }
+        }
+    }
+
+    free(queue);
+    free(visited);
+
+    return _GRAPH_OK__;
+}
+
+size_t graph_compressed_size(const struct graph_compressed *compressed)
+{
+    if (!compressed)
+        return 0;
+
+    return sizeof(struct graph_compressed) + 2 * compressed->vertices_amount * sizeof(size_t) \
+        + compressed->data_size + compressed->skips_amount * sizeof(size_t [2]);
+}
+
+void graph_compressed_free(struct graph_compressed *compressed)
+{
+    if (compressed)
+    {
+        free(compressed->offsets);
+        free(compressed->skip_starts);
+        free(compressed->data);
+        free(compressed->skips);
+    }
+
+    free(compressed);
+}
+
+// disk-backed graph
+
+static const char *__graph_disk_files[_GRAPH_DISK_SEGMENTS__] = \
+    { "offsets.bin", "edges.bin", "names.bin", "name_offsets.bin", "name_order.bin" };
+
+static const char __graph_disk_magic[8] = "GRAPHDSK";
+
+struct __graph_disk_meta
+{
+    char magic[8];
+    uint64_t vertices_amount;
+    uint64_t edges_amount;
+    uint64_t mode;
+};
+
+struct __graph_disk_edge
+{
+    uint64_t target;
+    uint64_t length;
+};
+
+struct __graph_disk_record
+{
+    uint32_t operation;
+    uint32_t name_size;
+    uint64_t start_vertex;
+    uint64_t end_vertex;
+    uint64_t length;
+};
+
+struct __graph_disk_change
+{
+    size_t start_vertex;
+    size_t end_vertex;
+    size_t length;
+    int present;
+};
+
+struct __graph_disk_page
+{
+    int segment;
+    size_t window;
+    unsigned char *address;
+    size_t size;
+    size_t used;
+};
+
+struct graph_disk
+{
+    char folder[_STRING__ + 1];
+    int files[_GRAPH_DISK_SEGMENTS__];
+    size_t file_sizes[_GRAPH_DISK_SEGMENTS__];
+    size_t hints[_GRAPH_DISK_SEGMENTS__];
+    struct __graph_disk_page *pages;
+    size_t pages_amount;
+    size_t clock;
+    graph_error_t error;
+    int mode;
+    size_t vertices_amount;
+    size_t edges_amount;
+    char **new_vertices;
+    size_t *new_order;
+    size_t new_vertices_amount;
+    struct __graph_disk_change *changes;
+    size_t changes_amount;
+    size_t changes_capacity;
+    FILE *log;
+};
+
+static const unsigned char __graph_disk_zeros[sizeof(struct __graph_disk_edge)] = {0};
+
+static int __graph_name_is_correct(const char *name)
+{
+    if (!name || !strlen(name) || strlen(name) > _STRING__)
+        return 0;
+
+    for (size_t i = 0; name[i] != '\0'; i++)
+    {
+        if (strchr(_GRAPH_FORBIDDEN_SEPARATORS__, name[i]))
+            return 0;
+    }
+
+    return 1;
+}
+
+static void __graph_disk_path(char *path, const char *folder, const char *file, const char *suffix)
+{
+    snprintf(path, _GRAPH_DISK_PATH__, "%s/%s%s", folder, file, suffix);
+}
+
+static graph_error_t __graph_disk_file_write(const char *folder, const char *file, const char *suffix, const void *data, size_t size)
+{
+    char path[_GRAPH_DISK_PATH__];
+    __graph_disk_path(path, folder, file, suffix);
+
+    FILE *stream = fopen(path, "wb");
+    if (!stream)
+        return _GRAPH_OS_ERROR__;
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (size && fwrite(data, 1, size, stream) != size)
+        rc = _GRAPH_OS_ERROR__;
+
+    if (fclose(stream))
+        rc = _GRAPH_OS_ERROR__;
+
+    return rc;
+}
+
+// pages cache
+
+static const unsigned char *__graph_disk_at(struct graph_disk *disk, int segment, size_t position)
+{
+    size_t window = position / _GRAPH_DISK_PAGE__;
+
+    struct __graph_disk_page *page = &disk->pages[disk->hints[segment]];
+
+    if (!page->address || page->segment != segment || page->window != window)
+    {
+        page = NULL;
+
+        for (size_t i = 0; i < disk->pages_amount && !page; i++)
+        {
+            if (disk->pages[i].address && disk->pages[i].segment == segment && disk->pages[i].window == window)
+                page = &disk->pages[i];
+        }
+    }
+
+    // mapping the window in place of the least recently used page
+
+    if (!page)
+    {
+        if (position >= disk->file_sizes[segment])
+        {
+            disk->error = _GRAPH_OS_ERROR__;
+            return __graph_disk_zeros;
+        }
+
+        page = &disk->pages[0];
+
+        for (size_t i = 1; i < disk->pages_amount && page->address; i++)
+        {
+            if (!disk->pages[i].address || disk->pages[i].used < page->used)
+                page = &disk->pages[i];
+        }
+
+        if (page->address)
+            munmap(page->address, page->size);
+
+        size_t offset = window * (size_t) _GRAPH_DISK_PAGE__;
+        size_t size = disk->file_sizes[segment] - offset < _GRAPH_DISK_PAGE__ ? disk->file_sizes[segment] - offset : _GRAPH_DISK_PAGE__;
+
+        void *address = mmap(NULL, size, PROT_READ, MAP_SHARED, disk->files[segment], (off_t) offset);
+
+        if (address == MAP_FAILED)
+        {
+            page->address = NULL;
+            disk->error = _GRAPH_OS_ERROR__;
+
+            return __graph_disk_zeros;
+        }
+
+        madvise(address, size, MADV_WILLNEED);
+
+        *page = (struct __graph_disk_page) { segment, window, address, size, 0 };
+    }
+
+    page->used = ++disk->clock;
+    disk->hints[segment] = page - disk->pages;
+
+    return page->address + position % _GRAPH_DISK_PAGE__;
+}
+
+static inline size_t __graph_disk_number(struct graph_disk *disk, int segment, size_t index)
+{
+    uint64_t value;
+    memcpy(&value, __graph_disk_at(disk, segment, index * sizeof(uint64_t)), sizeof(uint64_t));
+
+    return value;
+}
+
+static void __graph_disk_unmap(struct graph_disk *disk)
+{
+    for (size_t i = 0; i < disk->pages_amount; i++)
+    {
+        if (disk->pages[i].address)
+            munmap(disk->pages[i].address, disk->pages[i].size);
+
+        disk->pages[i] = (struct __graph_disk_page) {0};
+    }
+
+    for (int i = 0; i < _GRAPH_DISK_SEGMENTS__; i++)
+    {
+        if (disk->files[i] >= 0)
+            close(disk->files[i]);
+
+        disk->files[i] = -1;
+        disk->hints[i] = 0;
+    }
+}
+
+static graph_error_t __graph_disk_map(struct graph_disk *disk)
+{
+    char path[_GRAPH_DISK_PATH__];
+    __graph_disk_path(path, disk->folder, "meta.bin", "");
+
+    struct __graph_disk_meta meta;
+
+    FILE *stream = fopen(path, "rb");
+    if (!stream)
+        return _GRAPH_OS_ERROR__;
+
+    size_t read = fread(&meta, sizeof(meta), 1, stream);
+    fclose(stream);
+
+    if (read != 1 || memcmp(meta.magic, __graph_disk_magic, sizeof(meta.magic)))
+        return _GRAPH_OS_ERROR__;
+
+    disk->mode = meta.mode == _GRAPH_UNDIRECTED__ ? _GRAPH_UNDIRECTED__ : _GRAPH_DIRECTED__;
+    disk->vertices_amount = meta.vertices_amount;
+    disk->edges_amount = meta.edges_amount;
+
+    for (int i = 0; i < _GRAPH_DISK_SEGMENTS__; i++)
+    {
+        struct stat file_stat;
+
+        __graph_disk_path(path, disk->folder, __graph_disk_files[i], "");
+
+        disk->files[i] = open(path, O_RDONLY);
+
+        if (disk->files[i] < 0 || fstat(disk->files[i], &file_stat))
+        {
+            __graph_disk_unmap(disk);
+            return _GRAPH_OS_ERROR__;
+        }
+
+        disk->file_sizes[i] = file_stat.st_size;
+    }
+
+    posix_fadvise(disk->files[_GRAPH_DISK_EDGES__], 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    return _GRAPH_OK__;
+}
+
+// vertices names
+
+static void __graph_disk_name(struct graph_disk *disk, size_t index, char *vertex)
+{
+    if (index >= disk->vertices_amount)
+    {
+        strcpy(vertex, disk->new_vertices[index - disk->vertices_amount]);
+        return;
+    }
+
+    // a name can cross the border of pages
+
+    size_t position = __graph_disk_number(disk, _GRAPH_DISK_NAME_OFFSETS__, index);
+    size_t length = 0;
+
+    while (length < _STRING__)
+    {
+        const char *part = (const char *) __graph_disk_at(disk, _GRAPH_DISK_NAMES__, position + length);
+        size_t available = _GRAPH_DISK_PAGE__ - (position + length) % _GRAPH_DISK_PAGE__;
+
+        size_t i = 0;
+
+        while (i < available && length < _STRING__ && part[i] != '\0')
+            vertex[length++] = part[i++];
+
+        if (i < available)
+            break;
+    }
+
+    vertex[length] = '\0';
+}
+
+/**
+ * Position of the vertex name in the sorted order of new vertices
+*/
+static size_t __graph_disk_new_position(const struct graph_disk *disk, const char *vertex)
+{
+    size_t low = 0;
+    size_t high = disk->new_vertices_amount;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (strcmp(disk->new_vertices[disk->new_order[middle]], vertex) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+static size_t __graph_disk_find(struct graph_disk *disk, const char *vertex)
+{
+    char name[_STRING__ + 1];
+
+    size_t low = 0;
+    size_t high = disk->vertices_amount;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        size_t index = __graph_disk_number(disk, _GRAPH_DISK_NAME_ORDER__, middle);
+
+        __graph_disk_name(disk, index, name);
+
+        int comparison = strcmp(name, vertex);
+
+        if (!comparison)
+            return index;
+
+        if (comparison < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    size_t position = __graph_disk_new_position(disk, vertex);
+
+    if (position < disk->new_vertices_amount && !strcmp(disk->new_vertices[disk->new_order[position]], vertex))
+        return disk->vertices_amount + disk->new_order[position];
+
+    return graph_disk_vertices_amount(disk);
+}
+
+// delta of edges
+
+static size_t __graph_disk_change_position(const struct graph_disk *disk, size_t start_vertex, size_t end_vertex)
+{
+    size_t low = 0;
+    size_t high = disk->changes_amount;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        const struct __graph_disk_change *change = &disk->changes[middle];
+
+        if (change->start_vertex < start_vertex || (change->start_vertex == start_vertex && change->end_vertex < end_vertex))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+static graph_error_t __graph_disk_apply_edge(struct graph_disk *disk, size_t start_vertex, size_t end_vertex, size_t length, int present)
+{
+    size_t position = __graph_disk_change_position(disk, start_vertex, end_vertex);
+
+    if (position < disk->changes_amount && disk->changes[position].start_vertex == start_vertex \
+        && disk->changes[position].end_vertex == end_vertex)
+    {
+        disk->changes[position].length = length;
+        disk->changes[position].present = present;
+
+        return _GRAPH_OK__;
+    }
+
+    if (disk->changes_amount == disk->changes_capacity)
+    {
+        size_t capacity = disk->changes_capacity ? 2 * disk->changes_capacity : 64;
+
+        struct __graph_disk_change *tmp = realloc(disk->changes, capacity * sizeof(struct __graph_disk_change));
+        if (!tmp)
+            return _GRAPH_MEM__;
+
+        disk->changes = tmp;
+        disk->changes_capacity = capacity;
+    }
+
+    memmove(disk->changes + position + 1, disk->changes + position, (disk->changes_amount - position) * sizeof(struct __graph_disk_change));
+
+    disk->changes[position] = (struct __graph_disk_change) { start_vertex, end_vertex, length, present };
+    disk->changes_amount++;
+
+    return _GRAPH_OK__;
+}
+
+/**
+ * Edge of undirected graph is stored in both directions, a loop once
+*/
+static graph_error_t __graph_disk_apply_pair(struct graph_disk *disk, size_t start_vertex, size_t end_vertex, size_t length, int present)
+{
+    graph_error_t rc = __graph_disk_apply_edge(disk, start_vertex, end_vertex, length, present);
+
+    if (rc == _GRAPH_OK__ && disk->mode == _GRAPH_UNDIRECTED__ && start_vertex != end_vertex)
+        rc = __graph_disk_apply_edge(disk, end_vertex, start_vertex, length, present);
+
+    return rc;
+}
+
+static graph_error_t __graph_disk_apply_vertex(struct graph_disk *disk, const char *vertex)
+{
+    char **tmp = realloc(disk->new_vertices, (disk->new_vertices_amount + 1) * sizeof(char *));
+    if (!tmp)
+        return _GRAPH_MEM__;
+
+    disk->new_vertices = tmp;
+
+    size_t *order = realloc(disk->new_order, (disk->new_vertices_amount + 1) * sizeof(size_t));
+    if (!order)
+        return _GRAPH_MEM__;
+
+    disk->new_order = order;
+    disk->new_vertices[disk->new_vertices_amount] = strdup(vertex);
+
+    if (!disk->new_vertices[disk->new_vertices_amount])
+        return _GRAPH_MEM__;
+
+    // new vertices keep the order of their names for the binary search
+
+    size_t position = __graph_disk_new_position(disk, vertex);
+
+    memmove(order + position + 1, order + position, (disk->new_vertices_amount - position) * sizeof(size_t));
+
+    order[position] = disk->new_vertices_amount;
+    disk->new_vertices_amount++;
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_disk_log(struct graph_disk *disk, uint32_t operation, size_t start_vertex, size_t end_vertex, \
+    size_t length, const char *vertex)
+{
+    struct __graph_disk_record record = { operation, vertex ? strlen(vertex) : 0, start_vertex, end_vertex, length };
+
+    // the log is lost if a merge could not reopen it
+
+    if (!disk->log)
+        return _GRAPH_OS_ERROR__;
+
+    if (fwrite(&record, sizeof(record), 1, disk->log) != 1 \
+        || (record.name_size && fwrite(vertex, 1, record.name_size, disk->log) != record.name_size) \
+        || fflush(disk->log))
+        return _GRAPH_OS_ERROR__;
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_disk_replay(struct graph_disk *disk)
+{
+    char path[_GRAPH_DISK_PATH__];
+    __graph_disk_path(path, disk->folder, "delta.log", "");
+
+    FILE *stream = fopen(path, "rb");
+    if (!stream)
+        return errno == ENOENT ? _GRAPH_OK__ : _GRAPH_OS_ERROR__;
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    struct __graph_disk_record record;
+    char vertex[_STRING__ + 1];
+
+    long valid_size = 0;
+
+    while (rc == _GRAPH_OK__ && fread(&record, sizeof(record), 1, stream) == 1)
+    {
+        if (record.operation == _GRAPH_DISK_ADD_VERTEX__)
+        {
+            if (record.name_size > _STRING__ || fread(vertex, 1, record.name_size, stream) != record.name_size)
+                break;
+
+            vertex[record.name_size] = '\0';
+            rc = __graph_disk_apply_vertex(disk, vertex);
+        }
+        else if (record.operation == _GRAPH_DISK_ADD_EDGE__ || record.operation == _GRAPH_DISK_DELETE_EDGE__)
+        {
+            if (record.start_vertex >= graph_disk_vertices_amount(disk) || record.end_vertex >= graph_disk_vertices_amount(disk))
+                break;
+
+            rc = __graph_disk_apply_pair(disk, record.start_vertex, record.end_vertex, record.length, \
+                record.operation == _GRAPH_DISK_ADD_EDGE__);
+        }
+        else
+            break;
+
+        valid_size = ftell(stream);
+    }
+
+    fclose(stream);
+
+    // a record torn by a crash is cut off so that new records follow the valid ones
+
+    if (rc == _GRAPH_OK__ && truncate(path, valid_size))
+        rc = _GRAPH_OS_ERROR__;
+
+    return rc;
+}
+
+// neighbours of a vertex: sorted segment list merged with sorted changes
+
+struct __graph_disk_neighbours
+{
+    struct graph_disk *disk;
+    size_t edge;
+    size_t edges_end;
+    size_t change;
+    size_t changes_end;
+};
+
+static void __graph_disk_neighbours_init(struct graph_disk *disk, size_t vertex, struct __graph_disk_neighbours *neighbours)
+{
+    *neighbours = (struct __graph_disk_neighbours) { disk, 0, 0, 0, 0 };
+
+    if (vertex < disk->vertices_amount)
+    {
+        neighbours->edge = __graph_disk_number(disk, _GRAPH_DISK_OFFSETS__, vertex);
+        neighbours->edges_end = __graph_disk_number(disk, _GRAPH_DISK_OFFSETS__, vertex + 1);
+    }
+
+    neighbours->change = __graph_disk_change_position(disk, vertex, 0);
+    neighbours->changes_end = __graph_disk_change_position(disk, vertex + 1, 0);
+}
+
+static int __graph_disk_neighbours_next(struct __graph_disk_neighbours *neighbours, size_t *target, size_t *length)
+{
+    struct graph_disk *disk = neighbours->disk;
+
+    for (;;)
+    {
+        int has_edge = neighbours->edge < neighbours->edges_end;
+        int has_change = neighbours->change < neighbours->changes_end;
+
+        if (!has_edge && !has_change)
+            return 0;
+
+        struct __graph_disk_edge edge = {0};
+
+        if (has_edge)
+            memcpy(&edge, __graph_disk_at(disk, _GRAPH_DISK_EDGES__, neighbours->edge * sizeof(edge)), sizeof(edge));
+
+        if (has_change && (!has_edge || disk->changes[neighbours->change].end_vertex <= edge.target))
+        {
+            const struct __graph_disk_change *change = &disk->changes[neighbours->change++];
+
+            if (has_edge && change->end_vertex == edge.target)
+                neighbours->edge++;
+
+            if (!change->present)
+                continue;
+
+            *target = change->end_vertex;
+            *length = change->length;
+
+            return 1;
+        }
+
+        neighbours->edge++;
+
+        *target = edge.target;
+        *length = edge.length;
+
+        return 1;
+    }
+}
+
+static int __graph_disk_edge_exists(struct graph_disk *disk, size_t start_vertex, size_t end_vertex)
+{
+    size_t position = __graph_disk_change_position(disk, start_vertex, end_vertex);
+
+    if (position < disk->changes_amount && disk->changes[position].start_vertex == start_vertex \
+        && disk->changes[position].end_vertex == end_vertex)
+        return disk->changes[position].present;
+
+    if (start_vertex >= disk->vertices_amount)
+        return 0;
+
+    size_t low = __graph_disk_number(disk, _GRAPH_DISK_OFFSETS__, start_vertex);
+    size_t high = __graph_disk_number(disk, _GRAPH_DISK_OFFSETS__, start_vertex + 1);
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        size_t target = __graph_disk_number(disk, _GRAPH_DISK_EDGES__, 2 * middle);
+
+        if (target == end_vertex)
+            return 1;
+
+        if (target < end_vertex)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return 0;
+}
+
+graph_error_t graph_disk_create(const struct graph *graph, const char *folder)
+{
+    if (!graph || !folder || !strlen(folder) || strlen(folder) > _STRING__)
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (mkdir(folder, 0755) && errno != EEXIST)
+        return _GRAPH_OS_ERROR__;
+
+    size_t vertices_amount = graph->vertices_amount;
+
+    struct __graph_csr csr = {0};
+    struct __graph_name *names = __graph_names_create(graph);
+    uint64_t *numbers = malloc((vertices_amount + 1) * sizeof(uint64_t));
+    struct __graph_disk_edge *edges = NULL;
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (!names || !numbers)
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_csr_sorted_create(graph, &csr);
+
+    if (rc == _GRAPH_OK__)
+    {
+        edges = malloc((csr.edges_amount + 1) * sizeof(struct __graph_disk_edge));
+        if (!edges)
+            rc = _GRAPH_MEM__;
+    }
+
+    // segments are written under temporary names and replace the old ones at the end
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i <= vertices_amount; i++)
+            numbers[i] = csr.offsets[i];
+
+        for (size_t i = 0; i < csr.edges_amount; i++)
+            edges[i] = (struct __graph_disk_edge) { csr.targets[i], csr.lengths[i] };
+
+        rc = __graph_disk_file_write(folder, __graph_disk_files[_GRAPH_DISK_OFFSETS__], ".new", numbers, (vertices_amount + 1) * sizeof(uint64_t));
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_file_write(folder, __graph_disk_files[_GRAPH_DISK_EDGES__], ".new", edges, csr.edges_amount * sizeof(struct __graph_disk_edge));
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i < vertices_amount; i++)
+            numbers[i] = names[i].index;
+
+        rc = __graph_disk_file_write(folder, __graph_disk_files[_GRAPH_DISK_NAME_ORDER__], ".new", numbers, vertices_amount * sizeof(uint64_t));
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        char path[_GRAPH_DISK_PATH__];
+        __graph_disk_path(path, folder, __graph_disk_files[_GRAPH_DISK_NAMES__], ".new");
+
+        FILE *stream = fopen(path, "wb");
+        if (!stream)
+            rc = _GRAPH_OS_ERROR__;
+
+        size_t position = 0;
+
+        for (size_t i = 0; i < vertices_amount && rc == _GRAPH_OK__; i++)
+        {
+            size_t size = strlen(graph->vertices[i]) + 1;
+
+            numbers[i] = position;
+            position += size;
+
+            if (fwrite(graph->vertices[i], 1, size, stream) != size)
+                rc = _GRAPH_OS_ERROR__;
+        }
+
+        if (stream && fclose(stream))
+            rc = _GRAPH_OS_ERROR__;
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_file_write(folder, __graph_disk_files[_GRAPH_DISK_NAME_OFFSETS__], ".new", numbers, vertices_amount * sizeof(uint64_t));
+
+    if (rc == _GRAPH_OK__)
+    {
+        struct __graph_disk_meta meta = { {0}, vertices_amount, csr.edges_amount, graph->mode };
+        memcpy(meta.magic, __graph_disk_magic, sizeof(meta.magic));
+
+        rc = __graph_disk_file_write(folder, "meta.bin", ".new", &meta, sizeof(meta));
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_file_write(folder, "delta.log", "", NULL, 0);
+
+    for (int i = 0; i <= _GRAPH_DISK_SEGMENTS__ && rc == _GRAPH_OK__; i++)
+    {
+        char new_path[_GRAPH_DISK_PATH__];
+        char path[_GRAPH_DISK_PATH__];
+
+        const char *file = i < _GRAPH_DISK_SEGMENTS__ ? __graph_disk_files[i] : "meta.bin";
+
+        __graph_disk_path(new_path, folder, file, ".new");
+        __graph_disk_path(path, folder, file, "");
+
+        if (rename(new_path, path))
+            rc = _GRAPH_OS_ERROR__;
+    }
+
+    __graph_csr_free(&csr);
+
+    free(edges);
+    free(numbers);
+    free(names);
+
+    return rc;
+}
+
+static void __graph_disk_delta_free(struct graph_disk *disk)
+{
+    for (size_t i = 0; i < disk->new_vertices_amount; i++)
+        free(disk->new_vertices[i]);
+
+    free(disk->new_vertices);
+    free(disk->new_order);
+    free(disk->changes);
+
+    disk->new_vertices = NULL;
+    disk->new_order = NULL;
+    disk->new_vertices_amount = 0;
+    disk->changes = NULL;
+    disk->changes_amount = 0;
+    disk->changes_capacity = 0;
+}
+
+struct graph_disk *graph_disk_open(const char *folder, size_t cache_pages)
+{
+    if (!folder || !strlen(folder) || strlen(folder) > _STRING__)
+        return NULL;
+
+    struct graph_disk *disk = calloc(1, sizeof(struct graph_disk));
+    if (!disk)
+        return NULL;
+
+    strcpy(disk->folder, folder);
+
+    for (int i = 0; i < _GRAPH_DISK_SEGMENTS__; i++)
+        disk->files[i] = -1;
+
+    disk->pages_amount = cache_pages > _GRAPH_DISK_PAGES_MIN__ ? cache_pages : _GRAPH_DISK_PAGES_MIN__;
+    disk->pages = calloc(disk->pages_amount, sizeof(struct __graph_disk_page));
+
+    if (!disk->pages || __graph_disk_map(disk) != _GRAPH_OK__)
+    {
+        free(disk->pages);
+        free(disk);
+
+        return NULL;
+    }
+
+    char path[_GRAPH_DISK_PATH__];
+    __graph_disk_path(path, folder, "delta.log", "");
+
+    if (__graph_disk_replay(disk) != _GRAPH_OK__ || !(disk->log = fopen(path, "ab")))
+    {
+        graph_disk_close(disk);
+        return NULL;
+    }
+
+    return disk;
+}
+
+size_t graph_disk_vertices_amount(const struct graph_disk *disk)
+{
+    return disk ? disk->vertices_amount + disk->new_vertices_amount : 0;
+}
+
+graph_error_t graph_disk_vertex(struct graph_disk *disk, size_t index, char *vertex)
+{
+    if (!disk || !vertex)
+        return _GRAPH_INCORRECT_ARG__;
+
+    if (index >= graph_disk_vertices_amount(disk))
+        return _GRAPH_NOT_FOUND__;
+
+    disk->error = _GRAPH_OK__;
+
+    __graph_disk_name(disk, index, vertex);
+
+    return disk->error;
+}
+
+int graph_disk_has_edge(struct graph_disk *disk, const char *start_vertex, const char *end_vertex)
+{
+    if (!disk || !__graph_name_is_correct(start_vertex) || !__graph_name_is_correct(end_vertex))
+        return 0;
+
+    size_t vertices_amount = graph_disk_vertices_amount(disk);
+
+    size_t start = __graph_disk_find(disk, start_vertex);
+    size_t end = __graph_disk_find(disk, end_vertex);
+
+    return start != vertices_amount && end != vertices_amount && __graph_disk_edge_exists(disk, start, end);
+}
+
+static graph_error_t __graph_disk_modified(struct graph_disk *disk)
+{
+    if (disk->changes_amount + disk->new_vertices_amount >= _GRAPH_DISK_DELTA_MAX__)
+        return graph_disk_merge(disk);
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_disk_vertex_add(struct graph_disk *disk, const char *vertex)
+{
+    graph_error_t rc = __graph_disk_log(disk, _GRAPH_DISK_ADD_VERTEX__, 0, 0, 0, vertex);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_apply_vertex(disk, vertex);
+
+    return rc;
+}
+
+graph_error_t graph_disk_add_vertex(struct graph_disk *disk, const char *vertex)
+{
+    if (!disk || !__graph_name_is_correct(vertex))
+        return _GRAPH_INCORRECT_ARG__;
+
+    disk->error = _GRAPH_OK__;
+
+    if (__graph_disk_find(disk, vertex) != graph_disk_vertices_amount(disk))
+        return _GRAPH_EXIST__;
+
+    graph_error_t rc = __graph_disk_vertex_add(disk, vertex);
+
+    if (rc == _GRAPH_OK__)
+        rc = disk->error;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_modified(disk);
+
+    return rc;
+}
+
+graph_error_t graph_disk_add_edge(struct graph_disk *disk, const char *start_vertex, const char *end_vertex, size_t edge_length)
+{
+    if (!disk || !__graph_name_is_correct(start_vertex) || !__graph_name_is_correct(end_vertex))
+        return _GRAPH_INCORRECT_ARG__;
+
+    disk->error = _GRAPH_OK__;
+
+    size_t start = __graph_disk_find(disk, start_vertex);
+    size_t end = __graph_disk_find(disk, end_vertex);
+
+    if (start != graph_disk_vertices_amount(disk) && end != graph_disk_vertices_amount(disk) \
+        && __graph_disk_edge_exists(disk, start, end))
+        return _GRAPH_EXIST__;
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (start == graph_disk_vertices_amount(disk))
+        rc = __graph_disk_vertex_add(disk, start_vertex);
+
+    end = __graph_disk_find(disk, end_vertex);
+
+    if (rc == _GRAPH_OK__ && end == graph_disk_vertices_amount(disk))
+        rc = __graph_disk_vertex_add(disk, end_vertex);
+
+    if (rc == _GRAPH_OK__)
+    {
+        start = __graph_disk_find(disk, start_vertex);
+        end = __graph_disk_find(disk, end_vertex);
+
+        rc = __graph_disk_log(disk, _GRAPH_DISK_ADD_EDGE__, start, end, edge_length, NULL);
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_apply_pair(disk, start, end, edge_length, 1);
+
+    if (rc == _GRAPH_OK__)
+        rc = disk->error;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_modified(disk);
+
+    return rc;
+}
+
+graph_error_t graph_disk_delete_edge(struct graph_disk *disk, const char *start_vertex, const char *end_vertex)
+{
+    if (!disk || !__graph_name_is_correct(start_vertex) || !__graph_name_is_correct(end_vertex))
+        return _GRAPH_INCORRECT_ARG__;
+
+    disk->error = _GRAPH_OK__;
+
+    size_t start = __graph_disk_find(disk, start_vertex);
+    size_t end = __graph_disk_find(disk, end_vertex);
+
+    if (start == graph_disk_vertices_amount(disk) || end == graph_disk_vertices_amount(disk) \
+        || !__graph_disk_edge_exists(disk, start, end))
+        return disk->error != _GRAPH_OK__ ? disk->error : _GRAPH_NOT_FOUND__;
+
+    graph_error_t rc = __graph_disk_log(disk, _GRAPH_DISK_DELETE_EDGE__, start, end, 0, NULL);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_apply_pair(disk, start, end, 0, 0);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_modified(disk);
+
+    return rc;
+}
+
+static graph_error_t __graph_disk_merge_names(struct graph_disk *disk, FILE *names, FILE *name_offsets, FILE *name_order)
+{
+    char vertex[_STRING__ + 1];
+
+    graph_error_t rc = _GRAPH_OK__;
+    uint64_t position = 0;
+
+    // names and their positions in the order of indexes
+
+    for (size_t i = 0; i < graph_disk_vertices_amount(disk) && rc == _GRAPH_OK__; i++)
+    {
+        __graph_disk_name(disk, i, vertex);
+
+        size_t size = strlen(vertex) + 1;
+
+        if (fwrite(vertex, 1, size, names) != size || fwrite(&position, sizeof(position), 1, name_offsets) != 1)
+            rc = _GRAPH_OS_ERROR__;
+
+        position += size;
+    }
+
+    // merging the sorted order of old names with the sorted new names
+
+    for (size_t i = 0, j = 0; (i < disk->vertices_amount || j < disk->new_vertices_amount) && rc == _GRAPH_OK__; )
+    {
+        uint64_t index = 0;
+
+        if (i < disk->vertices_amount)
+        {
+            index = __graph_disk_number(disk, _GRAPH_DISK_NAME_ORDER__, i);
+            __graph_disk_name(disk, index, vertex);
+        }
+
+        if (j < disk->new_vertices_amount && (i == disk->vertices_amount \
+            || strcmp(disk->new_vertices[disk->new_order[j]], vertex) < 0))
+        {
+            index = disk->vertices_amount + disk->new_order[j];
+            j++;
+        }
+        else
+            i++;
+
+        if (fwrite(&index, sizeof(index), 1, name_order) != 1)
+            rc = _GRAPH_OS_ERROR__;
+    }
+
+    return rc;
+}
+
+graph_error_t graph_disk_merge(struct graph_disk *disk)
+{
+    if (!disk)
+        return _GRAPH_INCORRECT_ARG__;
+
+    disk->error = _GRAPH_OK__;
+
+    FILE *streams[_GRAPH_DISK_SEGMENTS__] = {0};
+    char path[_GRAPH_DISK_PATH__];
+    char new_path[_GRAPH_DISK_PATH__];
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    for (int i = 0; i < _GRAPH_DISK_SEGMENTS__ && rc == _GRAPH_OK__; i++)
+    {
+        __graph_disk_path(new_path, disk->folder, __graph_disk_files[i], ".new");
+
+        streams[i] = fopen(new_path, "wb");
+        if (!streams[i])
+            rc = _GRAPH_OS_ERROR__;
+    }
+
+    // edges lists are streamed vertex by vertex
+
+    uint64_t edges_amount = 0;
+    size_t vertices_amount = graph_disk_vertices_amount(disk);
+
+    for (size_t i = 0; i < vertices_amount && rc == _GRAPH_OK__; i++)
+    {
+        struct __graph_disk_neighbours neighbours;
+        struct __graph_disk_edge edge;
+        size_t target = 0;
+        size_t length = 0;
+
+        if (fwrite(&edges_amount, sizeof(edges_amount), 1, streams[_GRAPH_DISK_OFFSETS__]) != 1)
+            rc = _GRAPH_OS_ERROR__;
+
+        __graph_disk_neighbours_init(disk, i, &neighbours);
+
+        while (rc == _GRAPH_OK__ && __graph_disk_neighbours_next(&neighbours, &target, &length))
+        {
+            edge = (struct __graph_disk_edge) { target, length };
+            edges_amount++;
+
+            if (fwrite(&edge, sizeof(edge), 1, streams[_GRAPH_DISK_EDGES__]) != 1)
+                rc = _GRAPH_OS_ERROR__;
+        }
+    }
+
+    if (rc == _GRAPH_OK__ && fwrite(&edges_amount, sizeof(edges_amount), 1, streams[_GRAPH_DISK_OFFSETS__]) != 1)
+        rc = _GRAPH_OS_ERROR__;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_disk_merge_names(disk, streams[_GRAPH_DISK_NAMES__], streams[_GRAPH_DISK_NAME_OFFSETS__], streams[_GRAPH_DISK_NAME_ORDER__]);
+
+    if (rc == _GRAPH_OK__)
+        rc = disk->error;
+
+    for (int i = 0; i < _GRAPH_DISK_SEGMENTS__; i++)
+    {
+        if (streams[i] && fclose(streams[i]))
+            rc = _GRAPH_OS_ERROR__;
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        struct __graph_disk_meta meta = { {0}, vertices_amount, edges_amount, disk->mode };
+        memcpy(meta.magic, __graph_disk_magic, sizeof(meta.magic));
+
+        rc = __graph_disk_file_write(disk->folder, "meta.bin", ".new", &meta, sizeof(meta));
+    }
+
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    // replacing segments, the meta file goes last, the old ones are kept under links until all are replaced
+
+    int renamed = 0;
+    int linked = 0;
+
+    for (; linked <= _GRAPH_DISK_SEGMENTS__ && rc == _GRAPH_OK__; linked++)
+    {
+        const char *file = linked < _GRAPH_DISK_SEGMENTS__ ? __graph_disk_files[linked] : "meta.bin";
+
+        __graph_disk_path(path, disk->folder, file, "");
+        __graph_disk_path(new_path, disk->folder, file, ".old");
+
+        unlink(new_path);
+
+        if (link(path, new_path))
+        {
+            rc = _GRAPH_OS_ERROR__;
+            break;
+        }
+    }
+
+    for (; renamed <= _GRAPH_DISK_SEGMENTS__ && rc == _GRAPH_OK__; renamed++)
+    {
+        const char *file = renamed < _GRAPH_DISK_SEGMENTS__ ? __graph_disk_files[renamed] : "meta.bin";
+
+        __graph_disk_path(new_path, disk->folder, file, ".new");
+        __graph_disk_path(path, disk->folder, file, "");
+
+        if (rename(new_path, path))
+        {
+            rc = _GRAPH_OS_ERROR__;
+            break;
+        }
+    }
+
+    // on failure the replaced segments are restored, the mapping of the old ones is still valid
+
+    for (int i = 0; i < linked; i++)
+    {
+        const char *file = i < _GRAPH_DISK_SEGMENTS__ ? __graph_disk_files[i] : "meta.bin";
+
+        __graph_disk_path(new_path, disk->folder, file, ".old");
+        __graph_disk_path(path, disk->folder, file, "");
+
+        if (rc != _GRAPH_OK__ && i < renamed)
+            rename(new_path, path);
+        else
+            unlink(new_path);
+    }
+
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    __graph_disk_path(path, disk->folder, "delta.log", "");
+
+    fclose(disk->log);
+
+    disk->log = fopen(path, "wb");
+    if (!disk->log)
+        rc = _GRAPH_OS_ERROR__;
+
+    __graph_disk_unmap(disk);
+    __graph_disk_delta_free(disk);
+
+    graph_error_t map_rc = __graph_disk_map(disk);
+
+    return rc != _GRAPH_OK__ ? rc : map_rc;
+}
+
+static graph_error_t __graph_disk_source(struct graph_disk *disk, const char *source, size_t *source_index)
+{
+    if (!disk || !__graph_name_is_correct(source))
+        return _GRAPH_INCORRECT_ARG__;
+
+    disk->error = _GRAPH_OK__;
+
+    *source_index = __graph_disk_find(disk, source);
+
+    if (disk->error != _GRAPH_OK__)
+        return disk->error;
+
+    if (*source_index == graph_disk_vertices_amount(disk))
+        return _GRAPH_NOT_FOUND__;
+
+    return _GRAPH_OK__;
+}
+
+graph_error_t graph_disk_bfs(struct graph_disk *disk, const char *source, \
+    void (*vertex_processing)(const char *vertex_name, void *context), void *context)
+{
+    if (!vertex_processing)
+        return _GRAPH_INCORRECT_ARG__;
+
+    size_t source_index = 0;
+
+    graph_error_t rc = __graph_disk_source(disk, source, &source_index);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t vertices_amount = graph_disk_vertices_amount(disk);
+
+    size_t *queue = malloc(vertices_amount * sizeof(size_t));
+    unsigned char *visited = calloc(vertices_amount, sizeof(unsigned char));
+
+    if (!queue || !visited)
+        rc = _GRAPH_MEM__;
+
+    size_t head = 0;
+    size_t tail = 0;
+
+    if (rc == _GRAPH_OK__)
+    {
+        queue[tail++] = source_index;
+        visited[source_index] = 1;
+    }
+
+    while (rc == _GRAPH_OK__ && head < tail)
+    {
+        char vertex[_STRING__ + 1];
+        size_t index = queue[head++];
+
+        struct __graph_disk_neighbours neighbours;
+        size_t target = 0;
+        size_t length = 0;
+
+        __graph_disk_neighbours_init(disk, index, &neighbours);
+
+        while (__graph_disk_neighbours_next(&neighbours, &target, &length))
+        {
+            if (!visited[target])
+            {
+                visited[target] = 1;
+                queue[tail++] = target;
+            }
+        }
+
+        __graph_disk_name(disk, index, vertex);
+        rc = disk->error;
+
+        if (rc == _GRAPH_OK__)
+            vertex_processing(vertex, context);
+    }
+
+    free(queue);
+    free(visited);
+
+    return rc;
+}
+
+graph_error_t graph_disk_dfs(struct graph_disk *disk, const char *source, \
+    void (*vertex_processing)(const char *vertex_name, void *context), void *context)
+{
+    if (!vertex_processing)
+        return _GRAPH_INCORRECT_ARG__;
+
+    size_t source_index = 0;
+
+    graph_error_t rc = __graph_disk_source(disk, source, &source_index);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t vertices_amount = graph_disk_vertices_amount(disk);
+
+    // every stack frame keeps the position in the neighbours of its vertex
+
+    struct __graph_disk_neighbours *stack = malloc(vertices_amount * sizeof(struct __graph_disk_neighbours));
+    unsigned char *visited = calloc(vertices_amount, sizeof(unsigned char));
+
+    if (!stack || !visited)
+        rc = _GRAPH_MEM__;
+
+    size_t depth = 0;
+    size_t index = source_index;
+
+    while (rc == _GRAPH_OK__)
+    {
+        char vertex[_STRING__ + 1];
+
+        if (!visited[index])
+        {
+            visited[index] = 1;
+
+            __graph_disk_name(disk, index, vertex);
+            rc = disk->error;
+
+            if (rc == _GRAPH_OK__)
+                vertex_processing(vertex, context);
+
+            __graph_disk_neighbours_init(disk, index, &stack[depth++]);
+        }
+
+        size_t target = 0;
+        size_t length = 0;
+        int found = 0;
+
+        while (depth && !found)
+        {
+            found = __graph_disk_neighbours_next(&stack[depth - 1], &target, &length) && !visited[target];
+
+            if (!found && stack[depth - 1].edge >= stack[depth - 1].edges_end && stack[depth - 1].change >= stack[depth - 1].changes_end)
+                depth--;
+        }
+
+        if (!found)
+            break;
+
+        index = target;
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = disk->error;
+
+    free(stack);
+    free(visited);
+
+    return rc;
+}
+
+graph_error_t graph_disk_dijkstra(struct graph_disk *disk, const char *source, size_t *distances)
+{
+    if (!distances)
+        return _GRAPH_INCORRECT_ARG__;
+
+    size_t source_index = 0;
+
+    graph_error_t rc = __graph_disk_source(disk, source, &source_index);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t vertices_amount = graph_disk_vertices_amount(disk);
+
+    struct __graph_heap heap;
+
+    rc = __graph_heap_create(&heap, vertices_amount);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+        distances[i] = _GRAPH_INFINITY__;
+
+    distances[source_index] = 0;
+    __graph_heap_push(&heap, source_index, 0);
+
+    while (heap.size)
+    {
+        size_t index = __graph_heap_pop(&heap);
+        size_t distance = distances[index];
+
+        struct __graph_disk_neighbours neighbours;
+        size_t target = 0;
+        size_t length = 0;
+
+        __graph_disk_neighbours_init(disk, index, &neighbours);
+
+        while (__graph_disk_neighbours_next(&neighbours, &target, &length))
+        {
+            if (length < _GRAPH_INFINITY__ - distance && distance + length < distances[target])
+            {
+                distances[target] = distance + length;
+                __graph_heap_push(&heap, target, distances[target]);
+            }
+        }
+    }
+
+    __graph_heap_free(&heap);
+
+    return disk->error;
+}
+
+void graph_disk_close(struct graph_disk *disk)
+{
+    if (disk)
+    {
+        __graph_disk_unmap(disk);
+        __graph_disk_delta_free(disk);
+
+        if (disk->log)
+            fclose(disk->log);
+
+        free(disk->pages);
+    }
+
+    free(disk);
+}
+
+// reusable traversal workspace of a thread
+
+struct __graph_workspace
+{
+    const struct graph *graph;
+    size_t generation;
+    struct __graph_name *names;
+    struct __graph_csr csr;
+    size_t *stamps;
+    size_t *slots;
+    size_t *queue;
+    size_t capacity;
+    size_t epoch;
+};
+
+static pthread_key_t __graph_workspace_key;
+static pthread_once_t __graph_workspace_once = PTHREAD_ONCE_INIT;
+static int __graph_workspace_key_created = 0;
+
+static void __graph_workspace_destroy(void *context)
+{
+    struct __graph_workspace *workspace = context;
+
+    if (workspace)
+    {
+        __graph_csr_free(&workspace->csr);
+
+        free(workspace->names);
+        free(workspace->stamps);
+        free(workspace->slots);
+        free(workspace->queue);
+    }
+
+    free(workspace);
+}
+
+static void __graph_workspace_key_create(void)
+{
+    __graph_workspace_key_created = !pthread_key_create(&__graph_workspace_key, __graph_workspace_destroy);
+}
+
+static graph_error_t __graph_workspace_get(const struct graph *graph, struct __graph_workspace **workspace)
+{
+    pthread_once(&__graph_workspace_once, __graph_workspace_key_create);
+
+    if (!__graph_workspace_key_created)
+        return _GRAPH_MEM__;
+
+    *workspace = pthread_getspecific(__graph_workspace_key);
+
+    if (!*workspace)
+    {
+        *workspace = calloc(1, sizeof(struct __graph_workspace));
+
+        if (!*workspace || pthread_setspecific(__graph_workspace_key, *workspace))
+        {
+            free(*workspace);
+            return _GRAPH_MEM__;
+        }
+    }
+
+    struct __graph_workspace *current = *workspace;
+
+    if (current->graph == graph && current->generation == graph->generation && current->names)
+        return _GRAPH_OK__;
+
+    // indexing the graph again after its modifications
+
+    __graph_csr_free(&current->csr);
+    free(current->names);
+
+    current->graph = NULL;
+    current->names = __graph_names_create(graph);
+
+    if (!current->names)
+        return _GRAPH_MEM__;
+
+    graph_error_t rc = __graph_csr_create(graph, current->names, _GRAPH_CSR_FORWARD__, &current->csr);
+
+    // stamps are kept while they are large enough, older epochs never match
+
+    if (rc == _GRAPH_OK__ && current->capacity < graph->vertices_amount)
+    {
+        free(current->stamps);
+        free(current->slots);
+        free(current->queue);
+
+        current->capacity = graph->vertices_amount;
+        current->epoch = 0;
+
+        current->stamps = calloc(current->capacity, sizeof(size_t));
+        current->slots = malloc(current->capacity * sizeof(size_t));
+        current->queue = malloc(current->capacity * sizeof(size_t));
+
+        if (!current->stamps || !current->slots || !current->queue)
+        {
+            current->capacity = 0;
+            rc = _GRAPH_MEM__;
+        }
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        current->graph = graph;
+        current->generation = graph->generation;
+    }
+    else
+    {
+        free(current->names);
+        current->names = NULL;
+    }
+
+    return rc;
+}
+
+static inline size_t __graph_workspace_epoch(struct __graph_workspace *workspace)
+{
+    if (!++workspace->epoch)
+    {
+        memset(workspace->stamps, 0, workspace->capacity * sizeof(size_t));
+        workspace->epoch = 1;
+    }
+
+    return workspace->epoch;
+}
+
+graph_error_t graph_k_hop(const struct graph *graph, const char *source, size_t k, struct graph_neighbourhood *neighbourhood)
+{
+    if (!graph || !source || !strlen(source) || !neighbourhood)
+        return _GRAPH_INCORRECT_ARG__;
+
+    *neighbourhood = (struct graph_neighbourhood) {0};
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    struct __graph_workspace *workspace = NULL;
+
+    graph_error_t rc = __graph_workspace_get(graph, &workspace);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t source_index = __graph_names_find(workspace->names, graph->vertices_amount, source);
+    if (source_index == graph->vertices_amount)
+        return _GRAPH_NOT_FOUND__;
+
+    const struct __graph_csr *csr = &workspace->csr;
+    size_t *stamps = workspace->stamps;
+    size_t *queue = workspace->queue;
+    size_t epoch = __graph_workspace_epoch(workspace);
+
+    // breadth-first search level by level, slots keep the bounds of levels
+
+    size_t head = 0;
+    size_t tail = 0;
+    size_t levels = 0;
+
+    queue[tail++] = source_index;
+    stamps[source_index] = epoch;
+
+    while (head < tail && levels < k)
+    {
+        size_t level_end = tail;
+
+        workspace->slots[levels++] = level_end;
+
+        for (; head < level_end; head++)
+        {
+            size_t vertex = queue[head];
+
+            for (size_t i = csr->offsets[vertex]; i < csr->offsets[vertex + 1]; i++)
+            {
+                size_t target = csr->targets[i];
+
+                if (stamps[target] != epoch)
+                {
+                    stamps[target] = epoch;
+                    queue[tail++] = target;
+                }
+            }
+        }
+    }
+
+    neighbourhood->vertices = malloc(tail * sizeof(size_t));
+    neighbourhood->hops = malloc(tail * sizeof(size_t));
+
+    if (!neighbourhood->vertices || !neighbourhood->hops)
+    {
+        graph_neighbourhood_free(neighbourhood);
+        return _GRAPH_MEM__;
+    }
+
+    memcpy(neighbourhood->vertices, queue, tail * sizeof(size_t));
+    neighbourhood->vertices_amount = tail;
+
+    for (size_t i = 0, hop = 0; i < tail; i++)
+    {
+        while (hop < levels && i >= workspace->slots[hop])
+            hop++;
+
+        neighbourhood->hops[i] = hop;
+    }
+
+    return _GRAPH_OK__;
+}
+
+void graph_neighbourhood_free(struct graph_neighbourhood *neighbourhood)
+{
+    if (neighbourhood)
+    {
+        free(neighbourhood->vertices);
+        free(neighbourhood->hops);
+
+        *neighbourhood = (struct graph_neighbourhood) {0};
+    }
+}
+
+/**
+ * Undirected edges are in the adjacency of both vertices, the edge is taken once from its start vertex
+*/
+static inline int __graph_edge_is_stored(const struct graph *graph, size_t edge, size_t vertex)
+{
+    return graph->mode != _GRAPH_UNDIRECTED__ || !strcmp(graph->edges[edge].start_vertex, graph->vertices[vertex]);
+}
+
+graph_error_t graph_induced_subgraph(const struct graph *graph, const size_t *vertices, size_t vertices_amount, struct graph *subgraph)
+{
+    if (!graph || (!vertices && vertices_amount) || !subgraph)
+        return _GRAPH_INCORRECT_ARG__;
+
+    graph_initialize_mode(subgraph, graph->mode);
+
+    for (size_t i = 0; i < vertices_amount; i++)
+    {
+        if (vertices[i] >= graph->vertices_amount)
+            return _GRAPH_INCORRECT_ARG__;
+    }
+
+    if (!vertices_amount)
+        return _GRAPH_OK__;
+
+    struct __graph_workspace *workspace = NULL;
+
+    graph_error_t rc = __graph_workspace_get(graph, &workspace);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    const struct __graph_csr *csr = &workspace->csr;
+    size_t *stamps = workspace->stamps;
+    size_t epoch = __graph_workspace_epoch(workspace);
+
+    // marking the vertices, edges are counted before copying
+
+    size_t selected_amount = 0;
+    size_t edges_amount = 0;
+
+    for (size_t i = 0; i < vertices_amount; i++)
+    {
+        if (stamps[vertices[i]] != epoch)
+        {
+            stamps[vertices[i]] = epoch;
+            workspace->queue[selected_amount++] = vertices[i];
+        }
+    }
+
+    for (size_t i = 0; i < selected_amount; i++)
+    {
+        size_t vertex = workspace->queue[i];
+
+        for (size_t j = csr->offsets[vertex]; j < csr->offsets[vertex + 1]; j++)
+            edges_amount += stamps[csr->targets[j]] == epoch && __graph_edge_is_stored(graph, csr->edges[j], vertex);
+    }
+
+    subgraph->vertices = malloc(selected_amount * sizeof(char *));
+    subgraph->edges = malloc((edges_amount + 1) * sizeof(struct edge));
+
+    if (!subgraph->vertices || !subgraph->edges)
+        rc = _GRAPH_MEM__;
+
+    for (size_t i = 0; i < selected_amount && rc == _GRAPH_OK__; i++)
+    {
+        subgraph->vertices[i] = strdup(graph->vertices[workspace->queue[i]]);
+
+        if (!subgraph->vertices[i])
+            rc = _GRAPH_MEM__;
+        else
+            subgraph->vertices_amount++;
+    }
+
+    for (size_t i = 0; i < selected_amount && rc == _GRAPH_OK__; i++)
+    {
+        size_t vertex = workspace->queue[i];
+
+        for (size_t j = csr->offsets[vertex]; j < csr->offsets[vertex + 1]; j++)
+        {
+            if (stamps[csr->targets[j]] == epoch && __graph_edge_is_stored(graph, csr->edges[j], vertex))
+                subgraph->edges[subgraph->edges_amount++] = graph->edges[csr->edges[j]];
+        }
+    }
+
+    if (rc != _GRAPH_OK__)
+    {
+        graph_free(subgraph);
+        graph_initialize_mode(subgraph, graph->mode);
+    }
+
+    return rc;
+}
+
+void graph_workspace_free(void)
+{
+    pthread_once(&__graph_workspace_once, __graph_workspace_key_create);
+
+    if (__graph_workspace_key_created)
+    {
+        __graph_workspace_destroy(pthread_getspecific(__graph_workspace_key));
+        pthread_setspecific(__graph_workspace_key, NULL);
+    }
+}
+
+// multi-source breadth-first search
+
+/**
+ * Every vertex has bitsets of sources which have seen it and which visit it on the current and next levels,
+ * bitsets have fixed length so that loops over words are vectorized
+*/
+typedef uint64_t __graph_ms_bfs_set[_GRAPH_MS_BFS_WORDS__];
+
+static graph_error_t __graph_ms_bfs_batch(const struct __graph_csr *csr, const size_t *sources, size_t sources_amount, \
+    size_t *distances, void (*vertex_processing)(size_t source, size_t vertex, size_t hops, void *context), void *context)
+{
+    size_t vertices_amount = csr->vertices_amount;
+
+    __graph_ms_bfs_set *seen = calloc(vertices_amount, sizeof(__graph_ms_bfs_set));
+    __graph_ms_bfs_set *visit = calloc(vertices_amount, sizeof(__graph_ms_bfs_set));
+    __graph_ms_bfs_set *visit_next = calloc(vertices_amount, sizeof(__graph_ms_bfs_set));
+
+    if (!seen || !visit || !visit_next)
+    {
+        free(seen);
+        free(visit);
+        free(visit_next);
+
+        return _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < sources_amount; i++)
+    {
+        seen[sources[i]][i / 64] |= (uint64_t) 1 << (i % 64);
+        visit[sources[i]][i / 64] |= (uint64_t) 1 << (i % 64);
+
+        if (distances)
+            distances[i * vertices_amount + sources[i]] = 0;
+        else
+            vertex_processing(i, sources[i], 0, context);
+    }
+
+    for (size_t hops = 1, active = 1; active; hops++)
+    {
+        // every edge is scanned once per level for all sources
+
+        for (size_t vertex = 0; vertex < vertices_amount; vertex++)
+        {
+            uint64_t any = 0;
+
+            for (size_t w = 0; w < _GRAPH_MS_BFS_WORDS__; w++)
+                any |= visit[vertex][w];
+
+            if (!any)
+                continue;
+
+            for (size_t i = csr->offsets[vertex]; i < csr->offsets[vertex + 1]; i++)
+            {
+                uint64_t *target = visit_next[csr->targets[i]];
+
+                for (size_t w = 0; w < _GRAPH_MS_BFS_WORDS__; w++)
+                    target[w] |= visit[vertex][w];
+            }
+        }
+
+        active = 0;
+
+        for (size_t vertex = 0; vertex < vertices_amount; vertex++)
+        {
+            uint64_t any = 0;
+
+            for (size_t w = 0; w < _GRAPH_MS_BFS_WORDS__; w++)
+            {
+                uint64_t discovered = visit_next[vertex][w] & ~seen[vertex][w];
+
+                seen[vertex][w] |= discovered;
+                visit[vertex][w] = discovered;
+                visit_next[vertex][w] = 0;
+
+                any |= discovered;
+            }
+
+            if (!any)
+                continue;
+
+            active = 1;
+
+            for (size_t w = 0; w < _GRAPH_MS_BFS_WORDS__; w++)
+            {
+                for (uint64_t bits = visit[vertex][w]; bits; bits &= bits - 1)
+                {
+                    size_t source = w * 64 + __builtin_ctzll(bits);
+
+                    if (distances)
+                        distances[source * vertices_amount + vertex] = hops;
+                    else
+                        vertex_processing(source, vertex, hops, context);
+                }
+            }
+        }
+    }
+
+    free(seen);
+    free(visit);
+    free(visit_next);
+
+    return _GRAPH_OK__;
+}
+
+// sources of a batch are numbered from zero, the stream gets their numbers in the whole array
+
+struct __graph_ms_bfs_stream
+{
+    void (*vertex_processing)(size_t source, size_t vertex, size_t hops, void *context);
+    void *context;
+    size_t first;
+};
+
+static void __graph_ms_bfs_shift(size_t source, size_t vertex, size_t hops, void *context)
+{
+    struct __graph_ms_bfs_stream *stream = context;
+
+    stream->vertex_processing(stream->first + source, vertex, hops, stream->context);
+}
+
+static graph_error_t __graph_ms_bfs(const struct graph *graph, const char **sources, size_t sources_amount, size_t *distances, \
+    void (*vertex_processing)(size_t source, size_t vertex, size_t hops, void *context), void *context)
+{
+    if (!graph || (!sources && sources_amount))
+        return _GRAPH_INCORRECT_ARG__;
+
+    for (size_t i = 0; i < sources_amount; i++)
+    {
+        if (!sources[i] || !strlen(sources[i]))
+            return _GRAPH_INCORRECT_ARG__;
+    }
+
+    if (graph_is_empty(graph))
+        return _GRAPH_EMPTY__;
+
+    struct __graph_workspace *workspace = NULL;
+
+    graph_error_t rc = __graph_workspace_get(graph, &workspace);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    size_t *indexes = malloc((sources_amount + 1) * sizeof(size_t));
+    if (!indexes)
+        return _GRAPH_MEM__;
+
+    for (size_t i = 0; i < sources_amount && rc == _GRAPH_OK__; i++)
+    {
+        indexes[i] = __graph_names_find(workspace->names, graph->vertices_amount, sources[i]);
+
+        if (indexes[i] == graph->vertices_amount)
+            rc = _GRAPH_NOT_FOUND__;
+    }
+
+    if (rc == _GRAPH_OK__ && distances)
+    {
+        for (size_t i = 0; i < sources_amount * graph->vertices_amount; i++)
+            distances[i] = _GRAPH_INFINITY__;
+    }
+
+    // sources are searched in batches of the bitsets width
+
+    for (size_t first = 0; first < sources_amount && rc == _GRAPH_OK__; first += _GRAPH_MS_BFS_SOURCES__)
+    {
+        size_t batch = sources_amount - first < _GRAPH_MS_BFS_SOURCES__ ? sources_amount - first : _GRAPH_MS_BFS_SOURCES__;
+
+        if (distances)
+            rc = __graph_ms_bfs_batch(&workspace->csr, indexes + first, batch, distances + first * graph->vertices_amount, NULL, NULL);
+        else
+        {
+            struct __graph_ms_bfs_stream stream = { vertex_processing, context, first };
+            rc = __graph_ms_bfs_batch(&workspace->csr, indexes + first, batch, NULL, __graph_ms_bfs_shift, &stream);
+        }
+    }
+
+    free(indexes);
+
+    return rc;
+}
+
+graph_error_t graph_ms_bfs(const struct graph *graph, const char **sources, size_t sources_amount, size_t *distances)
+{
+    if (!distances)
+        return _GRAPH_INCORRECT_ARG__;
+
+    return __graph_ms_bfs(graph, sources, sources_amount, distances, NULL, NULL);
+}
+
+graph_error_t graph_ms_bfs_stream(const struct graph *graph, const char **sources, size_t sources_amount, \
+    void (*vertex_processing)(size_t source, size_t vertex, size_t hops, void *context), void *context)
+{
+    if (!vertex_processing)
+        return _GRAPH_INCORRECT_ARG__;
+
+    return __graph_ms_bfs(graph, sources, sources_amount, NULL, vertex_processing, context);
+}
+
+// layered drawing of graph
+
+/**
+ * Nodes of layout are vertices followed by dummy nodes splitting edges which span several layers,
+ * segments join nodes of neighbouring layers
+*/
+struct __graph_layered
+{
+    size_t vertices_amount;
+    size_t nodes_amount;
+    size_t layers_amount;
+    size_t segments_amount;
+    struct __graph_csr csr;
+    size_t *starts;
+    unsigned char *reversed;
+    size_t *dummies;
+    size_t *layers;
+    size_t *layer_offsets;
+    size_t *order;
+    size_t *positions;
+    size_t *up_offsets;
+    size_t *up;
+    size_t *down_offsets;
+    size_t *down;
+    double *x;
+    double *widths;
+};
+
+/**
+ * Marks of edges in cycle breaking
+*/
+#define _GRAPH_SVG_FORWARD__ 0
+#define _GRAPH_SVG_REVERSED__ 1
+#define _GRAPH_SVG_LOOP__ 2
+
+struct __graph_layered_key
+{
+    double key;
+    size_t position;
+    size_t node;
+};
+
+static int __graph_layered_key_compare(const void *first, const void *second)
+{
+    const struct __graph_layered_key *first_key = first;
+    const struct __graph_layered_key *second_key = second;
+
+    if (first_key->key != second_key->key)
+        return first_key->key < second_key->key ? -1 : 1;
+
+    return (first_key->position > second_key->position) - (first_key->position < second_key->position);
+}
+
+static void __graph_layered_free(struct __graph_layered *layered)
+{
+    __graph_csr_free(&layered->csr);
+
+    free(layered->starts);
+    free(layered->reversed);
+    free(layered->dummies);
+    free(layered->layers);
+    free(layered->layer_offsets);
+    free(layered->order);
+    free(layered->positions);
+    free(layered->up_offsets);
+    free(layered->up);
+    free(layered->down_offsets);
+    free(layered->down);
+    free(layered->x);
+    free(layered->widths);
+
+    *layered = (struct __graph_layered) {0};
+}
+
+static inline size_t __graph_layered_from(const struct __graph_layered *layered, size_t edge)
+{
+    return layered->reversed[edge] == _GRAPH_SVG_REVERSED__ ? layered->csr.targets[edge] : layered->starts[edge];
+}
+
+static inline size_t __graph_layered_to(const struct __graph_layered *layered, size_t edge)
+{
+    return layered->reversed[edge] == _GRAPH_SVG_REVERSED__ ? layered->starts[edge] : layered->csr.targets[edge];
+}
+
+/**
+ * Counting sort of pairs by keys into compressed rows
+*/
+static graph_error_t __graph_layered_rows(size_t rows_amount, size_t pairs_amount, const size_t *keys, const size_t *values, \
+    size_t **offsets, size_t **list)
+{
+    *offsets = calloc(rows_amount + 2, sizeof(size_t));
+    *list = malloc((pairs_amount + 1) * sizeof(size_t));
+
+    if (!*offsets || !*list)
+        return _GRAPH_MEM__;
+
+    for (size_t i = 0; i < pairs_amount; i++)
+        (*offsets)[keys[i] + 2]++;
+
+    for (size_t i = 0; i < rows_amount; i++)
+        (*offsets)[i + 2] += (*offsets)[i + 1];
+
+    for (size_t i = 0; i < pairs_amount; i++)
+        (*list)[(*offsets)[keys[i] + 1]++] = values[i];
+
+    return _GRAPH_OK__;
+}
+
+/**
+ * Cycle breaking by the greedy ordering of Eades, Lin and Smyth: sinks go to the end of the sequence, sources to its start,
+ * otherwise the vertex with the largest difference of out and in degrees goes to the start; edges against the sequence are reversed
+*/
+struct __graph_layered_buckets
+{
+    size_t *heads;
+    size_t *next;
+    size_t *previous;
+    size_t *buckets;
+    size_t *out_degrees;
+    size_t *in_degrees;
+    size_t max_degree;
+    size_t none;
+};
+
+static inline size_t __graph_layered_bucket(const struct __graph_layered_buckets *buckets, size_t vertex)
+{
+    // `0` - sinks, `1` - sources, then differences of degrees from `-max_degree` to `max_degree`
+
+    if (!buckets->out_degrees[vertex])
+        return 0;
+
+    if (!buckets->in_degrees[vertex])
+        return 1;
+
+    return 2 + buckets->max_degree + buckets->out_degrees[vertex] - buckets->in_degrees[vertex];
+}
+
+static void __graph_layered_unlink(struct __graph_layered_buckets *buckets, size_t vertex)
+{
+    if (buckets->previous[vertex] != buckets->none)
+        buckets->next[buckets->previous[vertex]] = buckets->next[vertex];
+    else
+        buckets->heads[buckets->buckets[vertex]] = buckets->next[vertex];
+
+    if (buckets->next[vertex] != buckets->none)
+        buckets->previous[buckets->next[vertex]] = buckets->previous[vertex];
+}
+
+static void __graph_layered_link(struct __graph_layered_buckets *buckets, size_t vertex)
+{
+    size_t bucket = __graph_layered_bucket(buckets, vertex);
+
+    buckets->buckets[vertex] = bucket;
+    buckets->previous[vertex] = buckets->none;
+    buckets->next[vertex] = buckets->heads[bucket];
+
+    if (buckets->heads[bucket] != buckets->none)
+        buckets->previous[buckets->heads[bucket]] = vertex;
+
+    buckets->heads[bucket] = vertex;
+}
+
+static graph_error_t __graph_layered_acyclic(struct __graph_layered *layered)
+{
+    const struct __graph_csr *csr = &layered->csr;
+    size_t vertices_amount = layered->vertices_amount;
+    size_t edges_amount = csr->edges_amount;
+
+    struct __graph_layered_buckets buckets = { .none = vertices_amount };
+
+    size_t *reverse_offsets = NULL;
+    size_t *reverse = NULL;
+    size_t *ranks = malloc((vertices_amount + 1) * sizeof(size_t));
+
+    buckets.next = malloc((vertices_amount + 1) * sizeof(size_t));
+    buckets.previous = malloc((vertices_amount + 1) * sizeof(size_t));
+    buckets.buckets = malloc((vertices_amount + 1) * sizeof(size_t));
+    buckets.out_degrees = calloc(vertices_amount + 1, sizeof(size_t));
+    buckets.in_degrees = calloc(vertices_amount + 1, sizeof(size_t));
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (!ranks || !buckets.next || !buckets.previous || !buckets.buckets || !buckets.out_degrees || !buckets.in_degrees)
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_rows(vertices_amount, edges_amount, csr->targets, layered->starts, &reverse_offsets, &reverse);
+
+    for (size_t i = 0; i < edges_amount && rc == _GRAPH_OK__; i++)
+    {
+        if (layered->starts[i] == csr->targets[i])
+        {
+            layered->reversed[i] = _GRAPH_SVG_LOOP__;
+            continue;
+        }
+
+        buckets.out_degrees[layered->starts[i]]++;
+        buckets.in_degrees[csr->targets[i]]++;
+    }
+
+    for (size_t i = 0; i < vertices_amount && rc == _GRAPH_OK__; i++)
+    {
+        if (buckets.out_degrees[i] > buckets.max_degree)
+            buckets.max_degree = buckets.out_degrees[i];
+
+        if (buckets.in_degrees[i] > buckets.max_degree)
+            buckets.max_degree = buckets.in_degrees[i];
+    }
+
+    size_t buckets_amount = 2 * buckets.max_degree + 3;
+
+    if (rc == _GRAPH_OK__)
+    {
+        buckets.heads = malloc(buckets_amount * sizeof(size_t));
+        if (!buckets.heads)
+            rc = _GRAPH_MEM__;
+    }
+
+    if (rc == _GRAPH_OK__)
+    {
+        for (size_t i = 0; i < buckets_amount; i++)
+            buckets.heads[i] = buckets.none;
+
+        for (size_t i = 0; i < vertices_amount; i++)
+            __graph_layered_link(&buckets, i);
+
+        size_t front = 0;
+        size_t back = vertices_amount;
+        size_t top = buckets_amount - 1;
+
+        while (front < back)
+        {
+            size_t vertex = buckets.heads[0];
+
+            if (vertex != buckets.none)
+                ranks[vertex] = --back;
+            else
+            {
+                vertex = buckets.heads[1];
+
+                if (vertex == buckets.none)
+                {
+                    while (buckets.heads[top] == buckets.none)
+                        top--;
+
+                    vertex = buckets.heads[top];
+                }
+
+                ranks[vertex] = front++;
+            }
+
+            // the vertex leaves the graph, degrees of its neighbours still in the graph are decreased
+
+            __graph_layered_unlink(&buckets, vertex);
+            buckets.buckets[vertex] = _GRAPH_NO_POSITION__;
+
+            for (size_t i = csr->offsets[vertex]; i < csr->offsets[vertex + 1]; i++)
+            {
+                size_t target = csr->targets[i];
+
+                if (target == vertex || buckets.buckets[target] == _GRAPH_NO_POSITION__)
+                    continue;
+
+                __graph_layered_unlink(&buckets, target);
+                buckets.in_degrees[target]--;
+                __graph_layered_link(&buckets, target);
+            }
+
+            for (size_t i = reverse_offsets[vertex]; i < reverse_offsets[vertex + 1]; i++)
+            {
+                size_t start = reverse[i];
+
+                if (start == vertex || buckets.buckets[start] == _GRAPH_NO_POSITION__)
+                    continue;
+
+                __graph_layered_unlink(&buckets, start);
+                buckets.out_degrees[start]--;
+                __graph_layered_link(&buckets, start);
+            }
+
+            // removing in-edges raises differences of degrees
+
+            for (size_t i = csr->offsets[vertex]; i < csr->offsets[vertex + 1]; i++)
+            {
+                size_t target = csr->targets[i];
+
+                if (buckets.buckets[target] != _GRAPH_NO_POSITION__ && buckets.buckets[target] > top)
+                    top = buckets.buckets[target];
+            }
+        }
+
+        for (size_t i = 0; i < edges_amount; i++)
+        {
+            if (layered->reversed[i] != _GRAPH_SVG_LOOP__ && ranks[layered->starts[i]] > ranks[csr->targets[i]])
+                layered->reversed[i] = _GRAPH_SVG_REVERSED__;
+        }
+    }
+
+    free(ranks);
+    free(reverse_offsets);
+    free(reverse);
+    free(buckets.heads);
+    free(buckets.next);
+    free(buckets.previous);
+    free(buckets.buckets);
+    free(buckets.out_degrees);
+    free(buckets.in_degrees);
+
+    return rc;
+}
+
+/**
+ * Layer assignment by the longest path from sources of the acyclic graph
+*/
+static graph_error_t __graph_layered_layers(struct __graph_layered *layered)
+{
+    size_t vertices_amount = layered->vertices_amount;
+    size_t edges_amount = layered->csr.edges_amount;
+
+    size_t *from = malloc((edges_amount + 1) * sizeof(size_t));
+    size_t *to = malloc((edges_amount + 1) * sizeof(size_t));
+    size_t *degrees = calloc(vertices_amount + 1, sizeof(size_t));
+    size_t *queue = malloc((vertices_amount + 1) * sizeof(size_t));
+    size_t *offsets = NULL;
+    size_t *list = NULL;
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (!from || !to || !degrees || !queue)
+        rc = _GRAPH_MEM__;
+
+    size_t pairs_amount = 0;
+
+    for (size_t i = 0; i < edges_amount && rc == _GRAPH_OK__; i++)
+    {
+        if (layered->reversed[i] == _GRAPH_SVG_LOOP__)
+            continue;
+
+        from[pairs_amount] = __graph_layered_from(layered, i);
+        to[pairs_amount] = __graph_layered_to(layered, i);
+        degrees[to[pairs_amount]]++;
+
+        pairs_amount++;
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_rows(vertices_amount, pairs_amount, from, to, &offsets, &list);
+
+    if (rc == _GRAPH_OK__)
+    {
+        size_t head = 0;
+        size_t tail = 0;
+
+        for (size_t i = 0; i < vertices_amount; i++)
+        {
+            layered->layers[i] = 0;
+
+            if (!degrees[i])
+                queue[tail++] = i;
+        }
+
+        while (head < tail)
+        {
+            size_t vertex = queue[head++];
+
+            if (layered->layers[vertex] + 1 > layered->layers_amount)
+                layered->layers_amount = layered->layers[vertex] + 1;
+
+            for (size_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+            {
+                if (layered->layers[list[i]] < layered->layers[vertex] + 1)
+                    layered->layers[list[i]] = layered->layers[vertex] + 1;
+
+                if (!--degrees[list[i]])
+                    queue[tail++] = list[i];
+            }
+        }
+    }
+
+    free(from);
+    free(to);
+    free(degrees);
+    free(queue);
+    free(offsets);
+    free(list);
+
+    return rc;
+}
+
+/**
+ * Splitting long edges by dummy nodes, ordering nodes in layers and joining neighbouring layers
+*/
+static graph_error_t __graph_layered_segments(struct __graph_layered *layered)
+{
+    size_t edges_amount = layered->csr.edges_amount;
+    size_t dummies_amount = 0;
+
+    for (size_t i = 0; i < edges_amount; i++)
+    {
+        if (layered->reversed[i] == _GRAPH_SVG_LOOP__)
+            continue;
+
+        size_t span = layered->layers[__graph_layered_to(layered, i)] - layered->layers[__graph_layered_from(layered, i)];
+
+        layered->segments_amount += span;
+        dummies_amount += span - 1;
+    }
+
+    layered->nodes_amount = layered->vertices_amount + dummies_amount;
+
+    size_t *tmp = realloc(layered->layers, (layered->nodes_amount + 1) * sizeof(size_t));
+    if (!tmp)
+        return _GRAPH_MEM__;
+
+    layered->layers = tmp;
+
+    size_t *uppers = malloc((layered->segments_amount + 1) * sizeof(size_t));
+    size_t *lowers = malloc((layered->segments_amount + 1) * sizeof(size_t));
+    size_t *layer_keys = malloc((layered->nodes_amount + 1) * sizeof(size_t));
+    size_t *nodes = malloc((layered->nodes_amount + 1) * sizeof(size_t));
+
+    graph_error_t rc = _GRAPH_OK__;
+
+    if (!uppers || !lowers || !layer_keys || !nodes)
+        rc = _GRAPH_MEM__;
+
+    if (rc == _GRAPH_OK__)
+    {
+        size_t node = layered->vertices_amount;
+        size_t segment = 0;
+
+        for (size_t i = 0; i < edges_amount; i++)
+        {
+            layered->dummies[i] = node;
+
+            if (layered->reversed[i] == _GRAPH_SVG_LOOP__)
+                continue;
+
+            size_t upper = __graph_layered_from(layered, i);
+            size_t to = __graph_layered_to(layered, i);
+
+            for (size_t layer = layered->layers[upper] + 1; layer < layered->layers[to]; layer++)
+            {
+                layered->layers[node] = layer;
+
+                uppers[segment] = upper;
+                lowers[segment++] = node;
+
+                upper = node++;
+            }
+
+            uppers[segment] = upper;
+            lowers[segment++] = to;
+        }
+
+        for (size_t i = 0; i < layered->nodes_amount; i++)
+        {
+            layer_keys[i] = layered->layers[i];
+            nodes[i] = i;
+        }
+
+        rc = __graph_layered_rows(layered->layers_amount, layered->nodes_amount, layer_keys, nodes, \
+            &layered->layer_offsets, &layered->order);
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_rows(layered->nodes_amount, layered->segments_amount, lowers, uppers, &layered->up_offsets, &layered->up);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_rows(layered->nodes_amount, layered->segments_amount, uppers, lowers, &layered->down_offsets, &layered->down);
+
+    if (rc == _GRAPH_OK__)
+    {
+        layered->positions = malloc((layered->nodes_amount + 1) * sizeof(size_t));
+        if (!layered->positions)
+            rc = _GRAPH_MEM__;
+    }
+
+    for (size_t layer = 0; layer < layered->layers_amount && rc == _GRAPH_OK__; layer++)
+    {
+        for (size_t i = layered->layer_offsets[layer]; i < layered->layer_offsets[layer + 1]; i++)
+            layered->positions[layered->order[i]] = i - layered->layer_offsets[layer];
+    }
+
+    free(uppers);
+    free(lowers);
+    free(layer_keys);
+    free(nodes);
+
+    return rc;
+}
+
+/**
+ * Crossings reduction: nodes of a layer are sorted by barycentres of their neighbours in the previous layer of the sweep
+*/
+static graph_error_t __graph_layered_order(struct __graph_layered *layered)
+{
+    struct __graph_layered_key *keys = malloc((layered->nodes_amount + 1) * sizeof(struct __graph_layered_key));
+    if (!keys)
+        return _GRAPH_MEM__;
+
+    for (size_t sweep = 0; sweep < 2 * _GRAPH_SVG_SWEEPS__; sweep++)
+    {
+        int downwards = !(sweep % 2);
+
+        const size_t *offsets = downwards ? layered->up_offsets : layered->down_offsets;
+        const size_t *neighbours = downwards ? layered->up : layered->down;
+
+        for (size_t step = 1; step < layered->layers_amount; step++)
+        {
+            size_t layer = downwards ? step : layered->layers_amount - 1 - step;
+
+            size_t first = layered->layer_offsets[layer];
+            size_t amount = layered->layer_offsets[layer + 1] - first;
+
+            for (size_t i = 0; i < amount; i++)
+            {
+                size_t node = layered->order[first + i];
+                double sum = 0;
+
+                for (size_t j = offsets[node]; j < offsets[node + 1]; j++)
+                    sum += layered->positions[neighbours[j]];
+
+                // nodes without neighbours keep their places
+
+                keys[i].key = offsets[node + 1] > offsets[node] ? sum / (offsets[node + 1] - offsets[node]) : (double) i;
+                keys[i].position = i;
+                keys[i].node = node;
+            }
+
+            qsort(keys, amount, sizeof(struct __graph_layered_key), __graph_layered_key_compare);
+
+            for (size_t i = 0; i < amount; i++)
+            {
+                layered->order[first + i] = keys[i].node;
+                layered->positions[keys[i].node] = i;
+            }
+        }
+    }
+
+    free(keys);
+
+    return _GRAPH_OK__;
+}
+
+/**
+ * Coordinates assignment: nodes are pulled to their neighbours, the order and gaps in layers are kept
+ * by averaging the leftmost and the rightmost placements
+*/
+static graph_error_t __graph_layered_coordinates(struct __graph_layered *layered, const struct graph *graph)
+{
+    size_t nodes_amount = layered->nodes_amount;
+
+    layered->x = malloc((nodes_amount + 1) * sizeof(double));
+    layered->widths = malloc((nodes_amount + 1) * sizeof(double));
+
+    double *left = malloc((nodes_amount + 1) * sizeof(double));
+    double *right = malloc((nodes_amount + 1) * sizeof(double));
+
+    if (!layered->x || !layered->widths || !left || !right)
+    {
+        free(left);
+        free(right);
+
+        return _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < nodes_amount; i++)
+        layered->widths[i] = i < layered->vertices_amount ? \
+            strlen(graph->vertices[i]) * _GRAPH_SVG_CHAR_WIDTH__ + _GRAPH_SVG_VERTICES_GAP__ : _GRAPH_SVG_DUMMY_WIDTH__;
+
+    for (size_t layer = 0; layer < layered->layers_amount; layer++)
+    {
+        double x = 0;
+
+        for (size_t i = layered->layer_offsets[layer]; i < layered->layer_offsets[layer + 1]; i++)
+        {
+            size_t node = layered->order[i];
+
+            layered->x[node] = x + layered->widths[node] / 2;
+            x += layered->widths[node] + _GRAPH_SVG_VERTICES_GAP__;
+        }
+    }
+
+    for (size_t sweep = 0; sweep < 2 * _GRAPH_SVG_SWEEPS__; sweep++)
+    {
+        int downwards = !(sweep % 2);
+
+        const size_t *offsets = downwards ? layered->up_offsets : layered->down_offsets;
+        const size_t *neighbours = downwards ? layered->up : layered->down;
+
+        for (size_t step = 1; step < layered->layers_amount; step++)
+        {
+            size_t layer = downwards ? step : layered->layers_amount - 1 - step;
+
+            size_t first = layered->layer_offsets[layer];
+            size_t last = layered->layer_offsets[layer + 1];
+
+            // desired places are the means of neighbours
+
+            for (size_t i = first; i < last; i++)
+            {
+                size_t node = layered->order[i];
+                double sum = 0;
+
+                for (size_t j = offsets[node]; j < offsets[node + 1]; j++)
+                    sum += layered->x[neighbours[j]];
+
+                left[i] = right[i] = offsets[node + 1] > offsets[node] ? sum / (offsets[node + 1] - offsets[node]) : layered->x[node];
+            }
+
+            for (size_t i = first + 1; i < last; i++)
+            {
+                double gap = (layered->widths[layered->order[i - 1]] + layered->widths[layered->order[i]]) / 2 + _GRAPH_SVG_VERTICES_GAP__;
+
+                if (left[i] < left[i - 1] + gap)
+                    left[i] = left[i - 1] + gap;
+            }
+
+            for (size_t i = last - 1; i > first; i--)
+            {
+                double gap = (layered->widths[layered->order[i - 1]] + layered->widths[layered->order[i]]) / 2 + _GRAPH_SVG_VERTICES_GAP__;
+
+                if (right[i - 1] > right[i] - gap)
+                    right[i - 1] = right[i] - gap;
+            }
+
+            for (size_t i = first; i < last; i++)
+                layered->x[layered->order[i]] = (left[i] + right[i]) / 2;
+        }
+    }
+
+    // moving the drawing to the margin
+
+    double min_x = 0;
+
+    for (size_t i = 0; i < nodes_amount; i++)
+    {
+        if (!i || layered->x[i] - layered->widths[i] / 2 < min_x)
+            min_x = layered->x[i] - layered->widths[i] / 2;
+    }
+
+    for (size_t i = 0; i < nodes_amount; i++)
+        layered->x[i] += _GRAPH_SVG_MARGIN__ - min_x;
+
+    free(left);
+    free(right);
+
+    return _GRAPH_OK__;
+}
+
+static graph_error_t __graph_layered_create(const struct graph *graph, struct __graph_layered *layered)
+{
+    *layered = (struct __graph_layered) {0};
+    layered->vertices_amount = graph->vertices_amount;
+
+    struct __graph_name *names = __graph_names_create(graph);
+    if (!names)
+        return _GRAPH_MEM__;
+
+    graph_error_t rc = __graph_csr_create(graph, names, _GRAPH_CSR_STORED__, &layered->csr);
+
+    free(names);
+
+    if (rc == _GRAPH_OK__)
+    {
+        size_t edges_amount = layered->csr.edges_amount;
+
+        layered->starts = malloc((edges_amount + 1) * sizeof(size_t));
+        layered->reversed = calloc(edges_amount + 1, sizeof(unsigned char));
+        layered->dummies = malloc((edges_amount + 1) * sizeof(size_t));
+        layered->layers = malloc((layered->vertices_amount + 1) * sizeof(size_t));
+
+        if (!layered->starts || !layered->reversed || !layered->dummies || !layered->layers)
+            rc = _GRAPH_MEM__;
+    }
+
+    for (size_t i = 0; i < layered->vertices_amount && rc == _GRAPH_OK__; i++)
+    {
+        for (size_t j = layered->csr.offsets[i]; j < layered->csr.offsets[i + 1]; j++)
+            layered->starts[j] = i;
+    }
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_acyclic(layered);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_layers(layered);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_segments(layered);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_order(layered);
+
+    if (rc == _GRAPH_OK__)
+        rc = __graph_layered_coordinates(layered, graph);
+
+    if (rc != _GRAPH_OK__)
+        __graph_layered_free(layered);
+
+    return rc;
+}
+
+static void __graph_svg_text(FILE *stream, const char *text)
+{
+    for (size_t i = 0; text[i] != '\0'; i++)
+    {
+        if (text[i] == '&')
+            fputs("&amp;", stream);
+        else if (text[i] == '<')
+            fputs("&lt;", stream);
+        else if (text[i] == '>')
+            fputs("&gt;", stream);
+        else if (text[i] == '"')
+            fputs("&quot;", stream);
+        else
+            fputc(text[i], stream);
+    }
+}
+
+static inline double __graph_svg_y(const struct __graph_layered *layered, size_t node)
+{
+    return _GRAPH_SVG_MARGIN__ + _GRAPH_SVG_VERTEX_HEIGHT__ / 2 + layered->layers[node] * _GRAPH_SVG_LAYERS_GAP__;
+}
+
+static void __graph_svg_edge(FILE *stream, const struct __graph_layered *layered, const struct graph *graph, size_t edge)
+{
+    size_t length = graph->edges[layered->csr.edges[edge]].length;
+    size_t start = layered->starts[edge];
+
+    double x = layered->x[start];
+    double y = __graph_svg_y(layered, start);
+
+    if (layered->reversed[edge] == _GRAPH_SVG_LOOP__)
+    {
+        double side = x + layered->widths[start] / 2;
+
+        fprintf(stream, "<path d=\"M%.1f,%.1f C%.1f,%.1f %.1f,%.1f %.1f,%.1f\" fill=\"none\" stroke=\"black\"%s/>\n", \
+            side, y - 6, side + 30, y - 24, side + 30, y + 24, side, y + 6, \
+            graph->mode == _GRAPH_UNDIRECTED__ ? "" : " marker-end=\"url(#arrow)\"");
+        fprintf(stream, "<text x=\"%.1f\" y=\"%.1f\" fill=\"blue\">%zu</text>\n", side + 26, y + 4, length);
+
+        return;
+    }
+
+    // points go from the upper node to the lower one, reversed edges get the arrow at the start
+
+    size_t from = __graph_layered_from(layered, edge);
+    size_t to = __graph_layered_to(layered, edge);
+    size_t dummies_amount = layered->layers[to] - layered->layers[from] - 1;
+
+    fprintf(stream, "<polyline points=\"%.1f,%.1f", layered->x[from], __graph_svg_y(layered, from) + _GRAPH_SVG_VERTEX_HEIGHT__ / 2);
+
+    for (size_t i = 0; i < dummies_amount; i++)
+    {
+        size_t node = layered->dummies[edge] + i;
+        fprintf(stream, " %.1f,%.1f", layered->x[node], __graph_svg_y(layered, node));
+    }
+
+    // undirected edges have no arrows
+
+    const char *marker = "";
+
+    if (graph->mode != _GRAPH_UNDIRECTED__)
+        marker = layered->reversed[edge] == _GRAPH_SVG_REVERSED__ ? " marker-start=\"url(#arrow)\"" : " marker-end=\"url(#arrow)\"";
+
+    fprintf(stream, " %.1f,%.1f\" fill=\"none\" stroke=\"black\"%s/>\n", layered->x[to], \
+        __graph_svg_y(layered, to) - _GRAPH_SVG_VERTEX_HEIGHT__ / 2, marker);
+
+    size_t label = dummies_amount ? layered->dummies[edge] + dummies_amount / 2 : to;
+
+    fprintf(stream, "<text x=\"%.1f\" y=\"%.1f\" fill=\"blue\">%zu</text>\n", (layered->x[from] + layered->x[label]) / 2 + 4, \
+        (__graph_svg_y(layered, from) + __graph_svg_y(layered, label)) / 2, length);
+}
+
+graph_error_t graph_render_svg(const struct graph *graph, FILE *stream)
+{
+    if (!graph || !stream)
+        return _GRAPH_INCORRECT_ARG__;
+
+    struct __graph_layered layered;
+
+    graph_error_t rc = __graph_layered_create(graph, &layered);
+    if (rc != _GRAPH_OK__)
+        return rc;
+
+    double width = 0;
+    double height = 2 * _GRAPH_SVG_MARGIN__ + _GRAPH_SVG_VERTEX_HEIGHT__ \
+        + (layered.layers_amount ? layered.layers_amount - 1 : 0) * _GRAPH_SVG_LAYERS_GAP__;
+
+    for (size_t i = 0; i < layered.nodes_amount; i++)
+    {
+        if (layered.x[i] + layered.widths[i] / 2 + _GRAPH_SVG_MARGIN__ > width)
+            width = layered.x[i] + layered.widths[i] / 2 + _GRAPH_SVG_MARGIN__;
+    }
+
+    // loops go beyond the right side of vertices
+
+    width += 40;
+
+    fprintf(stream, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" height=\"%.0f\" viewBox=\"0 0 %.0f %.0f\" " \
+        "font-family=\"monospace\" font-size=\"12\">\n", width, height, width, height);
+    fprintf(stream, "<defs><marker id=\"arrow\" viewBox=\"0 0 10 10\" refX=\"10\" refY=\"5\" markerWidth=\"8\" markerHeight=\"8\" " \
+        "orient=\"auto-start-reverse\"><path d=\"M0,0 L10,5 L0,10 z\"/></marker></defs>\n");
+
+    for (size_t i = 0; i < layered.csr.edges_amount; i++)
+        __graph_svg_edge(stream, &layered, graph, i);
+
+    for (size_t i = 0; i < layered.vertices_amount; i++)
+    {
+        double y = __graph_svg_y(&layered, i);
+
+        fprintf(stream, "<ellipse cx=\"%.1f\" cy=\"%.1f\" rx=\"%.1f\" ry=\"%.1f\" fill=\"white\" stroke=\"black\"/>\n", \
+            layered.x[i], y, layered.widths[i] / 2, _GRAPH_SVG_VERTEX_HEIGHT__ / 2);
+        fprintf(stream, "<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\" dominant-baseline=\"central\">", layered.x[i], y);
+
+        __graph_svg_text(stream, graph->vertices[i]);
+
+        fprintf(stream, "</text>\n");
+    }
+
+    fprintf(stream, "</svg>\n");
+
+    __graph_layered_free(&layered);
+
+    return ferror(stream) ? _GRAPH_OS_ERROR__ : _GRAPH_OK__;
+}
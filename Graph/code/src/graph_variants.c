@@ -0,0 +1,14 @@
+#include <math.h>
+#include "graph_variants.h"
+
+_GRAPH_TEMPLATE_DEFINE_UNWEIGHTED__(graph_unweighted, uint32_t, UINT32_MAX)
+
+_GRAPH_TEMPLATE_DEFINE_WEIGHTED__(graph_u16, uint32_t, uint16_t, uint64_t, UINT64_MAX)
+
+_GRAPH_TEMPLATE_DEFINE_WEIGHTED__(graph_u32, uint32_t, uint32_t, uint64_t, UINT64_MAX)
+
+_GRAPH_TEMPLATE_DEFINE_WEIGHTED__(graph_u64, uint32_t, uint64_t, uint64_t, UINT64_MAX)
+
+_GRAPH_TEMPLATE_DEFINE_WEIGHTED__(graph_f32, uint32_t, float, double, INFINITY)
+
+_GRAPH_TEMPLATE_DEFINE_WEIGHTED__(graph_f64, uint32_t, double, double, INFINITY)